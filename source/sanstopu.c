@@ -25,6 +25,28 @@
 #include <dos.h>
 #endif
 
+#if defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+#define USE_MMAP	/* statistics file is memory mapped */
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#endif
+
+#if defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+#define USE_THREADS	/* coupon rows can be drawn by worker threads (--threads) */
+#include <pthread.h>
+#include <sys/wait.h>	/* worker processes of the backtest (--backtest) */
+#define THREADLOCAL __thread
+#else
+#define THREADLOCAL
+#endif
+
+#if !defined(__MSDOS__)
+#define USE_SNAPSHOT	/* parsed statistics are cached in a binary snapshot file */
+#include <sys/types.h>
+#include <sys/stat.h>
+#endif
+
 #ifdef WIN32
 #include <windows.h> /* GetModuleFileName */
 #endif
@@ -59,7 +81,21 @@
 
 
 #define FILESTATS "sanstopu.txt"	// statistics file (winning numbers, plus numbers)
+#define FILEFIELDS 9                // numbers in a statistics file row (date and balls)
+#define BALLFIELD 3                 // first winning number in a statistics file row
+#define BONUSFIELD 8                // first plus number in a statistics file row
 #define OUTPUTFILE "output.txt"     // file to write results
+#define LARGECHUNK 60               // rows of a large coupon (--rows) drawn and written at a time (draw modes repeat every 30 rows)
+#define TOPMAX 100000               // most tickets of the ticket search (--top)
+#define TOPWEIGHT2 8                // ticket score of a lucky pair is its count times TOPWEIGHT2
+#define TOPWEIGHT3 64               // ticket score of a lucky triple is its count times TOPWEIGHT3
+#define SCOREBUF 65536              // output buffer of the batch scorer (--score)
+#define BACKTESTROWS 10             // rows of each draw mode drawn for a draw by the backtest (--backtest)
+#define PREFIXMAX 16777216          // most counts of the pair prefix table (--window), the pairs of a larger history are counted by rows
+#define NEAROVERLAP (DRAW_BALL-2)   // least common numbers of the near-duplicate draws (--near) unless --overlap is given
+#define SIMMAX 1000000              // most random histories of the Monte Carlo test (--simulate)
+#define COMBTABLEMAX 2147483648UL   // most slots of a combination count table (the slot count is a power of two in 32 bits)
+#define SIMSTATS (DRAW_BALL+2)      // statistics of a history: sum of the squares of the ball counts, most and least drawn counts, matched 2...DRAW_BALL combinations
 
 
 /* MS-DOS swap files for large FILESTATS due to lack of memory */
@@ -68,6 +104,12 @@
 #define LBL4SWAPFILE "luckybl4.swp"	// luckyBalls4 swap file
 
 
+/* Snapshot of FILESTATS (parsed draws, ball draw counts, lucky numbers and matching combinations) */
+#define SNAPSHOTEXT ".snap"			// snapshot file is FILESTATS + SNAPSHOTEXT
+#define SNAPSHOTMAGIC 0x50414E53	// "SNAP" (byte order of the snapshot is also checked by it)
+#define SNAPSHOTVERSION 2			// increase when the snapshot layout changes
+
+
 #define UINT16MAX 65535	// max file rows
 
 
@@ -87,6 +129,28 @@ typedef unsigned int UINT32;
 typedef int SINT32;
 #endif
 
+#if defined(LARGE_HISTORY) && !defined(__MSDOS__)
+typedef UINT32 UINTROW;					// row numbers and draw counts (build with -DLARGE_HISTORY for millions of draws)
+typedef unsigned long long UINTSUM;		// matching combination totals
+#define UINTROWMAX 4294967295U
+#else
+typedef UINT16 UINTROW;
+typedef UINT32 UINTSUM;
+#define UINTROWMAX UINT16MAX
+#endif
+
+typedef UINT32 UINTDAY;					// days apart (a history spanning centuries has more days than a 16 bit row number)
+
+#if defined(__MSDOS__)
+typedef unsigned long MASKWORD;			// ball bitmask word
+#define MASK_BITS 32
+#else
+typedef unsigned long long MASKWORD;	// ball bitmask word
+#define MASK_BITS 64
+#endif
+
+#define MASK_WORDS ((TOTAL_BALL + MASK_BITS - 1) / MASK_BITS)	// bitmask words of a draw (bit ball-1 is set for a drawn ball)
+
 
 
 /* GLOBAL VARIABLES */
@@ -96,6 +160,7 @@ typedef int SINT32;
 UINT8 currDay;
 UINT8 currMon;
 UINT16 currYear;
+UINT32 currEpochDay;	// day number of today
 
 
 
@@ -118,8 +183,9 @@ struct ListX {			/* List (drawn balls, statistics file row etc) */
 	UINT16 year;		// old drawn year
 	UINT8 mon;			// old drawn month
 	UINT8 day;			// old drawn day (year, month, day for statistics file rows)
-	UINT16 val;			// other value (how many times the numbers that drawn together, for lucky numbers)
-	UINT16 val2;		// other value (how many days apart on average, for lucky numbers)
+	UINT32 epochDay;	// day number of the date (days apart is a subtraction of day numbers)
+	UINTROW val;		// other value (how many times the numbers that drawn together, for lucky numbers)
+	UINTDAY val2;		// other value (how many days apart on average, for lucky numbers)
 	UINT8 *balls;		// ball array
 	UINT8 index;		// last item index in array (added items count, if index==0 array is empty)
 	UINT8 size;			// allocated total size of array
@@ -130,7 +196,7 @@ struct ListX {			/* List (drawn balls, statistics file row etc) */
 
 struct ListX2 {			/* List (globe, ballSortOrder: Sorting of balls by how many times each ball has been drawn in past draws) */
 	UINT8 *balls;		// ball array
-	UINT16 *vals;		// other info such as how many times the balls has been drawn so far
+	UINTROW *vals;		// other info such as how many times the balls has been drawn so far
 	UINT8 index;		// last item index in array (added items count, if index==0 array is empty)
 	UINT8 size;			// allocated total size of array
 };
@@ -139,16 +205,315 @@ struct ListX2 {			/* List (globe, ballSortOrder: Sorting of balls by how many ti
 
 struct ListXY {			/* 2 dimensions List. Multi draw (coupon or drawn balls from file has been drawn so far) */
 	struct ListX *list;	// list
+	struct CouponIndex *couponIndex;	// combinations of the rows (coupons), NULL if the rows are searched one by one
+};
+
+
+
+/**
+* The balls, pairs, triples and quartets of the coupon rows drawn so far are kept in bitsets indexed by the rank of
+* the combination, so a new row is checked with the coupon by probing its combinations instead of reading every row.
+* A large coupon (--rows) is drawn and written in chunks, only the rows of the current chunk are kept in the list.
+*/
+
+struct CouponIndex {	/* combinations of the coupon rows drawn so far */
+	MASKWORD *bits[5];	// bitsets of the 1...maxComb ball combinations (bit rank is set if a row has the combination)
+	UINT32 rows;		// rows added
+	UINT8 totalBall;	// total ball count
+	UINT8 maxComb;		// largest combination in the bitsets (at most 4)
+};
+
+
+/**
+* Drawn balls from the statistics file are kept in a contiguous table instead of a linked list.
+* Ball rows have a fixed width, so row i starts at balls[i*cols], and the dates are parallel columns
+* indexed by the same row number. Analysis passes read the rows one after the other without chasing
+* next pointers, and any row can be reached directly by its row number.
+* Each row also has a ball bitmask, so the number of balls two draws have in common is
+* found by AND and popcount of their bitmasks instead of searching every combination.
+*/
+
+struct TableXY {		/* 2 dimensions Table (drawn balls from file has been drawn so far, row 0 is the latest draw) */
+	UINT8 *balls;		// ball rows (rows*cols items)
+	MASKWORD *mask;		// ball bitmask rows (rows*MASK_WORDS items)
+	UINT16 *year;		// drawn year column
+	UINT8 *mon;			// drawn month column
+	UINT8 *day;			// drawn day column
+	UINT32 *epochDay;	// drawn day number column
+	UINTROW rows;		// added rows count (if rows==0 table is empty)
+	UINTROW size;		// allocated total row count
+	UINT8 cols;			// column count (number of balls in a row)
+};
+
+
+
+/**
+* Counts of the combinations of numbers that drawn together. Pairs are counted in a dense triangular
+* array indexed by the rank of the pair, larger combinations in a hash table keyed by their rank.
+* The counts are filled in one pass over the drawn balls table, so the numbers that drawn together
+* (lucky numbers) are found without comparing every pair of draws.
+*/
+
+struct CombCount {		/* how many times a combination of numbers has been drawn */
+	UINT32 rank;		// combination rank (colexicographic order of the sorted balls)
+	UINT8 balls[DRAW_BALL];	// sorted balls of the combination
+	UINTROW count;		// how many times the numbers drawn together (if count==0 slot is empty)
+	UINTROW first;		// latest row the numbers drawn together
+	UINTROW second;		// second latest row the numbers drawn together
+	UINTROW last;		// oldest row the numbers drawn together
+};
+
+
+
+struct CombTable {		/* combination counts of the drawn balls */
+	struct CombCount *items;	// slots
+	UINT32 size;		// allocated slot count
+	UINT32 used;		// used slot count
+	UINT8 comb;			// number of balls in a combination
+	UINT8 dense;		// 1 if the slots are indexed by the rank (pairs), 0 if the ranks are hashed
+};
+
+
+
+/**
+* The drawn balls table is also kept as an inverted index, a bitset of the draw rows for each ball (bit r is set if the ball
+* is drawn in row r). The draws that contain some numbers are the AND of the bitsets of the numbers, and the later draws that
+* share a pair with a draw are the OR of the ANDs of the bitsets of its pairs.
+*/
+
+struct BallPostings {	/* bitsets of the draw rows of the balls */
+	MASKWORD *bits;		// bitsets of the balls, bits[ball*words ... ball*words+words-1]
+	UINT32 words;		// words of a bitset
+	UINTROW rows;		// rows of the drawn balls table
+	UINT8 totalBall;	// total ball count
+};
+
+
+
+/**
+* The draw counts of the balls and the pairs are also kept as prefix sums by row: row r of a prefix table has the counts of
+* the latest r draws. The counts of the draws between two rows (a window of the draws) are the difference of the two rows,
+* and the row of the n-th latest draw of a pair in a window is found by a binary search over the rows of the pair.
+*/
+
+struct PrefixCounts {	/* prefix sums of the draw counts (row 0 is empty, row r has the counts of the rows 0...r-1 of the drawn balls table) */
+	UINTROW *balls;		// draw counts of the balls, balls[r*(totalBall+1)+ball]
+	UINTROW *pairs;		// draw counts of the pairs, pairs[r*pairCount+rank], NULL if the table is larger than PREFIXMAX or there is not enough memory
+	UINTROW rows;		// rows of the drawn balls table
+	UINT32 pairCount;	// number of the pairs
+	UINT8 totalBall;	// total ball count
+};
+
+
+
+/**
+* The lucky pairs, triples and quartets are kept in slots indexed by the rank of the combination (pairs) or
+* in a hash table keyed by the rank (triples and quartets), with the count and the days apart in the slot.
+* A drawn row is checked by looking up each of its combinations instead of comparing it with every lucky row.
+*/
+
+struct LuckyComb {		/* a lucky combination (count, days apart, latest draw) */
+	UINT32 rank;		// combination rank (colexicographic order of the sorted balls)
+	UINT32 epochDay;	// day number of the latest draw of the numbers
+	UINTROW val;		// how many times the numbers drawn together (if val==0 slot is empty)
+	UINTDAY val2;		// how many days apart on average
+};
+
+
+
+struct LuckyIndex {		/* lucky combinations of the same size */
+	struct LuckyComb *items;	// slots
+	UINT32 size;		// allocated slot count
+	UINT8 comb;			// number of balls in a combination
+	UINT8 dense;		// 1 if the slots are indexed by the rank (pairs), 0 if the ranks are hashed
+};
+
+
+
+/**
+* The ticket search (--top) scores every combination of the balls and keeps the best tickets. A ticket is scored by
+* the draw counts of its balls, the counts of its lucky pairs and triples and the draws since its balls were last drawn.
+* The tickets are enumerated ball by ball in ascending order and the scores of the balls that can follow the first balls
+* are kept in a row for each depth, so a ticket is scored with one addition and a row is extended by adding the pair and
+* triple rows of the new ball. The first balls are shared by the worker threads and every thread keeps its best tickets
+* in a bounded heap. Tickets of the same score are ordered by their rank, so the same tickets are found on any thread count.
+*/
+
+struct TopTicket {		/* ticket found by the ticket search */
+	SINT32 score;		// ticket score
+	UINT32 rank;		// combination rank (colexicographic order of the balls), the smaller rank is kept if the scores are the same
+	UINT8 balls[DRAW_BALL];	// sorted balls of the ticket
+};
+
+
+
+struct TopHeap {		/* best tickets found by a worker (min heap, items[0] is the worst ticket kept) */
+	struct TopTicket *items;	// tickets
+	UINT32 count;		// tickets kept
+	UINT32 size;		// most tickets to keep
+};
+
+
+
+struct TopSearch {		/* scores of the ticket search shared with the workers */
+	SINT32 *ballScore;	// score of a ball (draw count minus the draws since the ball was last drawn, TOTAL_BALL+1 items)
+	SINT32 *pairScore;	// score of the pair a<b at pairScore[a*(TOTAL_BALL+1)+b]
+	SINT32 *tripleScore;	// score of the triple a<b<c at tripleScore[(a*(TOTAL_BALL+1)+b)*(TOTAL_BALL+1)+c], NULL if there are no lucky triples
+	struct TopHeap *heaps;	// best tickets of the workers
+	UINT32 topCount;	// most tickets to find
+	UINT16 nextHeap;	// heap of the next worker thread (heaps[0] is used by the main thread)
+	UINT8 nextBall;		// next first ball to be taken by a worker
+	#ifdef USE_THREADS
+	pthread_mutex_t lock;	// lock of nextBall and nextHeap
+	#endif
+};
+
+
+
+struct MonteCarlo {		/* random histories of the Monte Carlo test shared with the workers */
+	UINTSUM observed[SIMSTATS];	// statistics of the drawn balls table
+	double sum[SIMSTATS];		// sums of the statistics of the random histories
+	UINT32 extreme[SIMSTATS];	// random histories with a statistic as extreme as observed (at least as large, at most as small for the least drawn count)
+	UINT32 histories;	// random histories to be simulated
+	UINT32 nextHistory;	// next history to be taken by a worker
+	UINTROW rows;		// draws of a history
+	#ifdef USE_THREADS
+	pthread_mutex_t lock;	// lock of nextHistory, sum and extreme
+	#endif
+};
+
+
+
+/**
+* The batch scorer (--score) reads tickets from a file and writes a score row for each ticket. The lucky combinations of
+* a ticket are looked up in the lucky index by their rank, and the ranks are summed from a table of the binomial
+* coefficients, so a ticket is scored without searching the lucky lists.
+*/
+
+struct TicketScore {	/* score of a ticket */
+	UINT32 draws;		// sum of the draw counts of the balls
+	UINT8 found[5];		// lucky pairs, triples and quartets of the ticket (found[2...4])
+	SINT32 days[5];		// days since a lucky combination of the ticket was last drawn (days[2...4], -1 if none)
+};
+
+
+
+/**
+* drawBallsByLucky walks from a ball to one of its partners in the lucky rows. The rows are sorted once and the partners
+* of every ball in the top rows are gathered in an array, so a partner is picked with one random index instead of
+* sorting the lucky list and trying random rows until one has the ball.
+*/
+
+struct LuckyPartners {	/* lucky pairs or triples sorted once for drawBallsByLucky */
+	UINT8 *balls;		// balls of the rows sorted by days apart and then by count, row i starts at balls[i*comb]
+	UINT8 *partners;	// partners of the balls in the top rows, partners[first[ball]...first[ball+1]-1] are the partners of the ball
+	UINT32 *first;		// index of the first partner of the balls (totalBall+2 items)
+	UINT32 rows;		// row count
+	UINT32 top;			// rows the partners are picked from (the rows drawn more times than the middle count)
+	UINT8 comb;			// number of balls in a row
+};
+
+
+
+/**
+* The index returned by gaussIndex is where a ball dropped on a pascal's triangle lands, so it follows a binomial
+* distribution. Instead of tossing a coin at every level of the triangle, the probability of every index is
+* calculated once for a ball count and an index is picked with one column and one coin of an alias table (Vose).
+*/
+
+struct AliasTable {		/* alias table of a discrete distribution */
+	double *prob;		// probability of keeping the column (else its alias is picked)
+	UINT8 *alias;		// alias index of the column
+	UINT8 size;			// column count (ball count)
+};
+
+
+
+/**
+* Random numbers are generated by xoshiro128** instead of rand(). It is faster, all bits of its output are
+* usable (balls are picked with modulo), and its state is kept in a struct, so every worker can have its own
+* stream. The streams of a seed are 2^64 numbers apart (jump), so they do not overlap.
+* The seed of the run is printed after the coupons. Running with --seed and drawing the same coupon counts
+* again in the same order draws the same coupons.
+*/
+
+struct Random {			/* xoshiro128** random number generator state */
+	UINT32 s[4];		// state words (never all zero)
+};
+
+
+
+#ifdef USE_THREADS
+
+/**
+* With --threads the rows of a coupon are drawn by worker threads. Every row gets a seed from the main stream and
+* every attempt of a row gets its own stream jumped from the row stream, so an attempt draws the same balls on any
+* thread. The workers draw the attempts of the rows ahead and check them with the lucky balls, then the main thread
+* checks them with the coupon in row order and takes the attempt that drawBalls would take. So the coupons of a seed
+* do not depend on the thread count. Lucky rows are drawn from the lucky balls lists by the main thread.
+*/
+
+#define DRAWBYNORM 1		// normal distribution
+#define DRAWBYLEFT 2		// left stacked
+#define DRAWBYBLEND1 3		// blend 1
+#define DRAWBYBLEND2 4		// blend 2
+#define DRAWBYSIDE 5		// side stacked
+#define DRAWBYRAND 6		// random
+#define DRAWBYLUCKY 7		// lucky
+
+struct DrawRow {		/* coupon row drawn by the workers */
+	UINT8 mode;			// DRAWBYNORM...DRAWBYLUCKY
+	UINT8 j;			// loop counter of drawBalls the row is drawn in
+	UINT8 count;		// attempts given to the workers
+	UINT8 next;			// next attempt to be checked with the coupon
+	UINT8 *balls;		// balls of the attempts (drawBallCount balls for each attempt)
+	UINT8 *eligible;	// 1 if the attempt passed the lucky balls checks
+	struct Random *streams;	// random number streams of the attempts
+};
+
+struct DrawJob {		/* attempts shared with the workers */
+	struct DrawRow *rows;	// rows of the coupon
+	UINT16 *units;		// attempts of the round (row << 8 | attempt)
+	UINT32 unitCount;	// attempt count of the round
+	UINT32 nextUnit;	// next attempt to be taken by a worker
+	pthread_mutex_t lock;	// lock of nextUnit
+	struct ListX2 *ballSortOrder;	// ball sort order at the start of the coupon (every attempt starts from it)
+	UINT8 totalBall;
+	UINT8 drawBallCount;
+	UINT8 numOfAttempts;
+};
+
+#endif
+
+
+
+/**
+* Parsing the statistics file and counting the numbers that drawn together are done once. The results are saved
+* to a binary snapshot file next to the statistics file and loaded from it on the next start.
+* The snapshot is used only if it was written by the same version and layout from a statistics file of
+* the same size, modification time and contents hash. New draws are added to the top of the statistics file,
+* so if the draws in the snapshot are still the last rows of the changed file, only the new draws are counted
+* and compared with the old draws. Otherwise the statistics file is parsed again and the snapshot is rewritten.
+*/
+
+struct SnapshotHeader {	/* snapshot file header */
+	UINT32 magic;		// SNAPSHOTMAGIC (0 until the snapshot is completely written)
+	UINT32 version;		// SNAPSHOTVERSION
+	UINT32 layout;		// sizes of the types and ball counts the snapshot is written with
+	UINT32 fileSize;	// size of the statistics file
+	UINT32 fileTime;	// modification time of the statistics file
+	UINT32 fileHash;	// FNV-1a hash of the statistics file contents
 };
 
 
 
+
 /* Drawn balls lists from file has been drawn so far */
 
-struct ListXY *winningDrawnBallsList = NULL;
-struct ListXY *plusNumberDrawnBallsList = NULL;
-UINT16 winningBallRows = 0;
-UINT16 pNumberBallRows = 0;
+struct TableXY *winningDrawnBallsList = NULL;
+struct TableXY *plusNumberDrawnBallsList = NULL;
+UINTROW winningBallRows = 0;
+UINTROW pNumberBallRows = 0;
 
 
 /* Old drawn dates between dateStart and dateEnd */
@@ -157,7 +522,12 @@ char dateStart[11], dateEnd[11];
 
 /* Old drawn days count between dateStart and dateEnd */
 
-UINT16 drawnDays;
+UINTDAY drawnDays;
+
+
+/* Latest and oldest rows of the statistics (a window of the draws, --window, or all the draws) */
+
+UINTROW windowFirst = 0, windowLast = 0;
 
 
 /* How many times were the winning numbers drawn in the previous draws? */
@@ -173,12 +543,54 @@ struct ListXY *luckyBalls3 = NULL;
 struct ListXY *luckyBalls4 = NULL;
 
 
+/* Bitsets of the draw rows of the balls (draws that contain some numbers, matched combinations) */
+
+struct BallPostings *ballPostings = NULL;
+
+
+/* Prefix sums of the draw counts by row (the statistics of a window of the draws, --window), NULL on MS-DOS */
+
+struct PrefixCounts *prefixCounts = NULL;
+
+
+/* Lucky numbers indexed by the rank of the combination (luckyIndex[2...4]), NULL if the lucky lists are searched row by row */
+
+struct LuckyIndex *luckyIndex[5] = {NULL, NULL, NULL, NULL, NULL};
+
+
+/* Lucky pairs and triples sorted for drawBallsByLucky, NULL on MS-DOS (the lucky numbers are read from the swap files) */
+
+struct LuckyPartners *luckyPartners2 = NULL;
+struct LuckyPartners *luckyPartners3 = NULL;
+
+
 /* Matched combinations of numbers from previous draws */
 
-UINT32 match2comb = 0;
-UINT32 match3comb = 0;
-UINT32 match4comb = 0;
-UINT32 match5comb = 0;
+UINTSUM match2comb = 0;
+UINTSUM match3comb = 0;
+UINTSUM match4comb = 0;
+UINTSUM match5comb = 0;
+
+
+/* Alias tables of gaussIndex by ball count (created on first use) */
+
+struct AliasTable *gaussTables[256];
+
+
+/* Random number stream of the draws and its seed (--seed or current time) */
+
+THREADLOCAL struct Random rng;
+UINT32 randomSeed;
+
+
+/* Worker threads of drawBalls (set by --threads, if 0 the rows are drawn one by one) */
+
+UINT8 drawThreads = 0;
+
+
+/* printPercentOfProgress prints nothing if 0 (while a large coupon is drawn) */
+
+UINT8 showProgress = 1;
 
 
 
@@ -199,7 +611,21 @@ UINT32 match5comb = 0;
  *
  * @return {Integer}    : Returns the difference between two dates in days
 */
-UINT16 dateDiff(UINT8 d1, UINT8 m1, UINT16 y1, UINT8 d2, UINT8 m2, UINT16 y2);
+UINTDAY dateDiff(UINT8 d1, UINT8 m1, UINT16 y1, UINT8 d2, UINT8 m2, UINT16 y2);
+
+
+
+/**
+ * Returns the day number of the date (days since a fixed epoch). The difference between two dates
+ * in days is the difference of their day numbers, so the day numbers of the drawn balls are calculated once.
+ *
+ * @param {Integer} day     : day
+ * @param {Integer} mon     : month
+ * @param {Integer} year    : year
+ *
+ * @return {Integer}        : Returns the day number of the date
+*/
+UINT32 getEpochDay(UINT8 day, UINT8 mon, UINT16 year);
 
 
 
@@ -268,7 +694,7 @@ UINT8 isIntString(char* input);
  * @param {Integer} day       : day
  * @return {struct ListX *}   : refers to the ball list (memory allocated)
  */
-struct ListX *createListX(struct ListX *pl, UINT8 size, char *label, UINT16 val, UINT16 val2, UINT16 year, UINT8 mon, UINT8 day);
+struct ListX *createListX(struct ListX *pl, UINT8 size, char *label, UINTROW val, UINTDAY val2, UINT16 year, UINT8 mon, UINT8 day);
 
 
 
@@ -292,163 +718,446 @@ struct ListX2 *createListX2(struct ListX2 *pl, UINT8 size);
 struct ListXY *createListXY(struct ListXY *pl);
 
 
-
-/** 
- * Add an item (ball) to the beginning of the list
- *
- * @param {struct ListX2 *}    : refers to a ball list
- * @param {Integer} key        : the key to which the ball will be added
- */
-void insertItem2(struct ListX2 *pl, UINT8 key);
-
-
-
 /**
- * Add an item (ball) to the end of the list
+ * Create Empty 2 dimensions Table
  * 
- * @param {struct ListX *}     : refers to a ball list
- * @param {Integer} key        : the key to which the ball will be added
+ * @param {struct TableXY *} pt : refers to a drawn balls table
+ * @param {Integer} cols        : column count (number of balls in a row)
+ * @param {Integer} size        : initial row count to be allocated (the table grows when it is full)
+ * @return {struct TableXY *}   : refers to the drawn balls table (memory allocated)
  */
-void appendItem(struct ListX *pl, UINT8 key);
+struct TableXY *createTableXY(struct TableXY *pt, UINT8 cols, UINTROW size);
 
 
 
 /** 
- * Add an item (ball) with key->val pair to the end of the list
+ * Add a row (a draw) to the end of the table
  *
- * @param {struct ListX2 *}    : refers to a ball list
- * @param {Integer} key        : the key to which the ball will be added
- * @param {Integer} val        : value
+ * @param {struct TableXY *} pt : refers to a drawn balls table
+ * @param {UINT8 *} keys        : balls of the row (cols items)
+ * @param {Integer} year        : year
+ * @param {Integer} mon         : month
+ * @param {Integer} day         : day
+ * @return {Integer}            : returns 1 on success, 0 if the table is full or memory could not be allocated
  */
-void appendItem2(struct ListX2 *pl, UINT8 key, UINT16 val);
+UINT8 appendRowT(struct TableXY *pt, UINT8 *keys, UINT16 year, UINT8 mon, UINT8 day);
 
 
 
 /** 
- * Add multiple items (balls) to the end of the list
+ * Return the balls of the row at the specified row number
  * 
- * @param {struct ListX *}     : refers to a ball list
- * @param {Integer *} keys     : the keys to which the ball will be added
+ * @param {struct TableXY *} pt : refers to a drawn balls table
+ * @param {Integer} ind         : row number (0 is the latest draw)
+ * @return {UINT8 *}            : refers to the first ball of the row
  */
-void appendItems(struct ListX *pl, UINT8 *keys);
+UINT8 *getRowT(struct TableXY *pt, UINTROW ind);
 
 
 
 /** 
- * Insert a list to the beginning of the 2 dimensions list
+ * Return the row at the specified row number as a 1 dimension list.
+ * No memory is allocated, balls of the list refer to the table row. So the list can be passed
+ * to the functions working on a ball list (search2CombX, printListXByKey etc.) but must not be modified.
  * 
- * @param {struct ListXY *}    : refers to a 2 dimensions ball list (multiple draws)
- * @param {struct ListX *}     : refers to a ball list
+ * @param {struct TableXY *} pt : refers to a drawn balls table
+ * @param {Integer} ind         : row number (0 is the latest draw)
+ * @param {struct ListX *} pl   : refers to the list to be filled
+ * @return {struct ListX *}     : refers to the filled list (pl)
  */
-void insertList(struct ListXY *pl, struct ListX *newList);
+struct ListX *getListXByRow(struct TableXY *pt, UINTROW ind, struct ListX *pl);
 
 
 
 /** 
- * Add a list to the end of the 2 dimensions list
- * 
- * @param {struct ListXY *}    : refers to a 2 dimensions ball list (multiple draws)
- * @param {struct ListX *}     : refers to a ball list
+ * Remove all rows in the table and release the allocated memory of the columns
+ *
+ * @param {struct TableXY *} pt : refers to a drawn balls table
  */
-void appendList(struct ListXY *pl, struct ListX *plNext);
+void removeAllT(struct TableXY *pt);
 
 
 
 /** 
- * Removes item and returns the key (ball number) at the specified index from the list
- * 
- * @param {struct ListX2 *}    : refers to a ball list
- * @param {Integer} ind        : the index to which the ball will be removed
- * @return {Integer}           : returns key (ball number)
+ * Set the bitmask of the balls (bit ball-1 is set for each ball)
+ *
+ * @param {MASKWORD *} mask     : refers to the bitmask (MASK_WORDS items)
+ * @param {UINT8 *} balls       : balls
+ * @param {Integer} count       : ball count
  */
-UINT8 removeItemByIndex2(struct ListX2 *pl, UINT8 ind);
+void setMaskX(MASKWORD *mask, UINT8 *balls, UINT8 count);
 
 
 
 /** 
- * If the specified key is not in the list, it adds to the specified index and returns 1
+ * Return how many balls two bitmasks have in common (popcount of mask1 AND mask2)
  *
- * @param {struct ListX2 *}    : refers to a ball list
- * @param {Integer} ind        : the index to which the ball will be added
- * @param {Integer} key        : key (ball number)
- * @return {Integer}           : If the key is in the list, it does not add it to the list and return 0
+ * @param {MASKWORD *} mask1    : refers to the first bitmask (MASK_WORDS items)
+ * @param {MASKWORD *} mask2    : refers to the second bitmask (MASK_WORDS items)
+ * @return {Integer}            : number of common balls
  */
-UINT8 addItemByIndex2(struct ListX2 *pl, UINT8 ind, UINT8 key);
+UINT8 popCountMask(MASKWORD *mask1, MASKWORD *mask2);
 
 
 
 /** 
- * It adds to the specified index
- * 
- * @param {struct ListXY *}    : refers to a 2 dimensions ball list
- * @param {struct ListX *}     : new list
- * @param {Integer} ind        : the index to which the list will be added
- * @return {Integer}           : It adds to the specified index
+ * Return how many balls two rows of the table have in common
+ *
+ * @param {struct TableXY *} pt : refers to a drawn balls table
+ * @param {Integer} ind1        : first row number
+ * @param {Integer} ind2        : second row number
+ * @return {Integer}            : number of common balls
  */
-void addListByIndex(struct ListXY *pl, struct ListX *newList, UINT16 ind);
+UINT8 overlapCountT(struct TableXY *pt, UINTROW ind1, UINTROW ind2);
 
 
 
 /** 
- * Removes list and returns at the specified index from the 2 dimensions list
+ * Create empty combination count table
  *
- * @param {struct ListXY *}    : refers to a 2 dimensions ball list
- * @param {Integer} ind        : the index to which the ball will be removed
- * @return {Integer}           : returns key (ball number)
+ * @param {struct CombTable *} pc : refers to a combination count table
+ * @param {Integer} comb          : number of balls in a combination
+ * @param {Integer} totalBall     : total ball count (the largest ball)
+ * @param {Integer} maxItems      : maximum number of different combinations to be counted (used if comb > 2)
+ * @return {struct CombTable *}   : refers to the combination count table (memory allocated), NULL if there is not enough memory
  */
-struct ListX * removeListByIndex(struct ListXY *pl, UINT16 ind);
+struct CombTable *createCombTable(struct CombTable *pc, UINT8 comb, UINT8 totalBall, UINT32 maxItems);
 
 
 
 /** 
- * Shuffle a 2 dimensions list
+ * Return the rank of a combination. The rank of the sorted balls b1 < b2 < ... < bk is
+ * C(b1-1,1) + C(b2-1,2) + ... + C(bk-1,k), so every combination has a different rank.
  *
- * @param {struct ListXY *}    : refers to a 2 dimensions ball list
- * @return {struct ListXY *}   : return list
+ * @param {UINT8 *} balls         : sorted balls of the combination
+ * @param {Integer} comb          : number of balls in the combination
+ * @return {Integer}              : rank of the combination
  */
-struct ListXY * shuffleListXY(struct ListXY *pl);
+UINT32 combRank(UINT8 *balls, UINT8 comb);
 
 
 
-/**
- * Remove all items in the list
- * 
- * @param {struct ListX *}     : refers to a ball list
+/** 
+ * Return the count slot of a combination. An empty slot is assigned to the combination if it is not counted yet.
+ *
+ * @param {struct CombTable *} pc : refers to a combination count table
+ * @param {UINT8 *} balls         : sorted balls of the combination
+ * @return {struct CombCount *}   : refers to the count slot, NULL if the table is full
  */
-void removeAllX(struct ListX *pl);
+struct CombCount *getCombCount(struct CombTable *pc, UINT8 *balls);
 
 
 
 /** 
- * Remove all items in the list
- * 
- * @param {struct ListX2 *}     : refers to a ball list
+ * Count the combinations of every row of the drawn balls table in one pass
+ *
+ * @param {struct TableXY *} pt   : refers to a drawn balls table
+ * @param {struct CombTable *} pc : refers to a combination count table
+ * @return {Integer}              : returns 1 if every combination is counted, 0 if the table is full
  */
-void removeAllX2(struct ListX2 *pl);
+UINT8 countCombT(struct TableXY *pt, struct CombTable *pc);
 
 
 
 /** 
- * Remove all list in the 2 dimensions list
+ * Count the combinations of a row of the drawn balls table as the latest row counted so far
+ * (rows are counted from the oldest to the latest, so the counts are updated draw by draw)
  *
- * @param {struct ListXY *}    : refers to a 2 dimensions ball list (multiple draws)
+ * @param {struct TableXY *} pt   : refers to a drawn balls table
+ * @param {struct CombTable *} pc : refers to a combination count table
+ * @param {Integer} r             : row number (older rows must be counted before)
+ * @return {Integer}              : returns 1 if every combination is counted, 0 if the table is full
  */
-void removeAllXY(struct ListXY *pl);
+UINT8 countCombRowT(struct TableXY *pt, struct CombTable *pc, UINTROW r);
 
 
 
 /** 
- * Return the number of list in the 2 dimensions list
- * 
- * @param {struct ListXY *}    : refers to a 2 dimensions ball list (multiple draws)
- * @return {Integer}           : Return the number of list in the 2 dimensions list
+ * Create the prefix sums of the draw counts of the balls and the pairs of the drawn balls table
+ *
+ * @param {struct PrefixCounts *} pp  : refers to the prefix counts
+ * @param {struct TableXY *} pt       : refers to a drawn balls table
+ * @param {Integer} totalBall         : total ball count
+ * @return {struct PrefixCounts *}    : refers to the prefix counts (memory allocated), NULL if there is not enough memory
  */
-UINT16 lengthY(struct ListXY *pl);
+struct PrefixCounts *createPrefixCounts(struct PrefixCounts *pp, struct TableXY *pt, UINT8 totalBall);
 
 
 
 /** 
- * Find the pointer of the list at the end of the 2 dimensions list
+ * Release the allocated memory of the prefix counts
+ *
+ * @param {struct PrefixCounts *} pp  : refers to the prefix counts
+ */
+void removePrefixCounts(struct PrefixCounts *pp);
+
+
+
+/** 
+ * Returns the row of the n-th latest draw of a pair in the rows first...last
+ *
+ * @param {struct PrefixCounts *} pp  : refers to the prefix counts
+ * @param {Integer} rank              : rank of the pair
+ * @param {Integer} first             : latest row of the window
+ * @param {Integer} last              : oldest row of the window
+ * @param {Integer} n                 : 1 for the latest draw of the pair (the pair must be drawn at least n times in the window)
+ * @return {Integer}                  : row number
+ */
+UINTROW getPrefixRow(struct PrefixCounts *pp, UINT32 rank, UINTROW first, UINTROW last, UINTROW n);
+
+
+
+/** 
+ * Create the bitsets of the draw rows of the balls of the drawn balls table
+ *
+ * @param {struct BallPostings *} pp  : refers to the ball postings
+ * @param {struct TableXY *} pt       : refers to a drawn balls table
+ * @param {Integer} totalBall         : total ball count
+ * @return {struct BallPostings *}    : refers to the ball postings (memory allocated), NULL if there is not enough memory
+ */
+struct BallPostings *createBallPostings(struct BallPostings *pp, struct TableXY *pt, UINT8 totalBall);
+
+
+
+/** 
+ * Release the allocated memory of the ball postings
+ *
+ * @param {struct BallPostings *} pp  : refers to the ball postings
+ */
+void removeBallPostings(struct BallPostings *pp);
+
+
+
+/** 
+ * Get the draw rows that contain all of the balls (AND of the bitsets of the balls)
+ *
+ * @param {struct BallPostings *} pp  : refers to the ball postings
+ * @param {UINT8 *} balls             : balls
+ * @param {Integer} count             : number of the balls
+ * @param {MASKWORD *} rowBits        : bitset of the rows is assigned to this address (pp->words items)
+ * @return {Integer}                  : number of the rows
+ */
+UINTROW getDrawRows(struct BallPostings *pp, UINT8 *balls, UINT8 count, MASKWORD *rowBits);
+
+
+
+/** 
+ * Get the draw rows from the row first on that contain a pair of the balls (OR of the ANDs of the bitsets of the pairs)
+ *
+ * @param {struct BallPostings *} pp  : refers to the ball postings
+ * @param {UINT8 *} balls             : balls
+ * @param {Integer} count             : number of the balls
+ * @param {Integer} first             : first row
+ * @param {MASKWORD *} rowBits        : bitset of the rows is assigned to this address (pp->words items)
+ */
+void getPairRows(struct BallPostings *pp, UINT8 *balls, UINT8 count, UINTROW first, MASKWORD *rowBits);
+
+
+
+/** 
+ * Returns the first row from the row r on that is set in the bitset of the rows
+ *
+ * @param {struct BallPostings *} pp  : refers to the ball postings
+ * @param {MASKWORD *} rowBits        : bitset of the rows (pp->words items)
+ * @param {Integer} r                 : row number
+ * @return {Integer}                  : row number, pp->rows if there is no row
+ */
+UINTROW nextDrawRow(struct BallPostings *pp, MASKWORD *rowBits, UINTROW r);
+
+
+
+/** 
+ * Compare function of qsort for combination counts. Sorts by count (descending), then by the latest row,
+ * the second latest row and the balls of the combination (ascending).
+ *
+ * @param {const void *} p1       : refers to the first combination count pointer
+ * @param {const void *} p2       : refers to the second combination count pointer
+ * @return {Integer}              : -1, 0 or 1
+ */
+int compareCombCount(const void *p1, const void *p2);
+
+
+
+/** 
+ * Add the combinations drawn more than once to the list, sorted by how many times the numbers drawn together.
+ * val of a list is how many times the numbers drawn together, val2 is how many days apart on average
+ * and the date is the latest draw date of the numbers.
+ *
+ * @param {struct ListXY *} pl    : refers to the lucky numbers list
+ * @param {struct CombTable *} pc : refers to a combination count table
+ * @param {struct TableXY *} pt   : refers to the drawn balls table which has been counted
+ * @return {struct ListXY *}      : refers to the lucky numbers list
+ */
+struct ListXY *getCombCountList(struct ListXY *pl, struct CombTable *pc, struct TableXY *pt);
+
+
+
+/** 
+ * Release the allocated memory of the combination count table
+ *
+ * @param {struct CombTable *} pc : refers to a combination count table
+ */
+void removeAllC(struct CombTable *pc);
+
+
+
+
+/** 
+ * Add an item (ball) to the beginning of the list
+ *
+ * @param {struct ListX2 *}    : refers to a ball list
+ * @param {Integer} key        : the key to which the ball will be added
+ */
+void insertItem2(struct ListX2 *pl, UINT8 key);
+
+
+
+/**
+ * Add an item (ball) to the end of the list
+ * 
+ * @param {struct ListX *}     : refers to a ball list
+ * @param {Integer} key        : the key to which the ball will be added
+ */
+void appendItem(struct ListX *pl, UINT8 key);
+
+
+
+/** 
+ * Add an item (ball) with key->val pair to the end of the list
+ *
+ * @param {struct ListX2 *}    : refers to a ball list
+ * @param {Integer} key        : the key to which the ball will be added
+ * @param {Integer} val        : value
+ */
+void appendItem2(struct ListX2 *pl, UINT8 key, UINTROW val);
+
+
+
+/** 
+ * Add multiple items (balls) to the end of the list
+ * 
+ * @param {struct ListX *}     : refers to a ball list
+ * @param {Integer *} keys     : the keys to which the ball will be added
+ */
+void appendItems(struct ListX *pl, UINT8 *keys);
+
+
+
+/** 
+ * Insert a list to the beginning of the 2 dimensions list
+ * 
+ * @param {struct ListXY *}    : refers to a 2 dimensions ball list (multiple draws)
+ * @param {struct ListX *}     : refers to a ball list
+ */
+void insertList(struct ListXY *pl, struct ListX *newList);
+
+
+
+/** 
+ * Add a list to the end of the 2 dimensions list
+ * 
+ * @param {struct ListXY *}    : refers to a 2 dimensions ball list (multiple draws)
+ * @param {struct ListX *}     : refers to a ball list
+ */
+void appendList(struct ListXY *pl, struct ListX *plNext);
+
+
+
+/** 
+ * Removes item and returns the key (ball number) at the specified index from the list
+ * 
+ * @param {struct ListX2 *}    : refers to a ball list
+ * @param {Integer} ind        : the index to which the ball will be removed
+ * @return {Integer}           : returns key (ball number)
+ */
+UINT8 removeItemByIndex2(struct ListX2 *pl, UINT8 ind);
+
+
+
+/** 
+ * If the specified key is not in the list, it adds to the specified index and returns 1
+ *
+ * @param {struct ListX2 *}    : refers to a ball list
+ * @param {Integer} ind        : the index to which the ball will be added
+ * @param {Integer} key        : key (ball number)
+ * @return {Integer}           : If the key is in the list, it does not add it to the list and return 0
+ */
+UINT8 addItemByIndex2(struct ListX2 *pl, UINT8 ind, UINT8 key);
+
+
+
+/** 
+ * It adds to the specified index
+ * 
+ * @param {struct ListXY *}    : refers to a 2 dimensions ball list
+ * @param {struct ListX *}     : new list
+ * @param {Integer} ind        : the index to which the list will be added
+ * @return {Integer}           : It adds to the specified index
+ */
+void addListByIndex(struct ListXY *pl, struct ListX *newList, UINTROW ind);
+
+
+
+/** 
+ * Removes list and returns at the specified index from the 2 dimensions list
+ *
+ * @param {struct ListXY *}    : refers to a 2 dimensions ball list
+ * @param {Integer} ind        : the index to which the ball will be removed
+ * @return {Integer}           : returns key (ball number)
+ */
+struct ListX * removeListByIndex(struct ListXY *pl, UINTROW ind);
+
+
+
+/** 
+ * Shuffle a 2 dimensions list
+ *
+ * @param {struct ListXY *}    : refers to a 2 dimensions ball list
+ * @return {struct ListXY *}   : return list
+ */
+struct ListXY * shuffleListXY(struct ListXY *pl);
+
+
+
+/**
+ * Remove all items in the list
+ * 
+ * @param {struct ListX *}     : refers to a ball list
+ */
+void removeAllX(struct ListX *pl);
+
+
+
+/** 
+ * Remove all items in the list
+ * 
+ * @param {struct ListX2 *}     : refers to a ball list
+ */
+void removeAllX2(struct ListX2 *pl);
+
+
+
+/** 
+ * Remove all list in the 2 dimensions list
+ *
+ * @param {struct ListXY *}    : refers to a 2 dimensions ball list (multiple draws)
+ */
+void removeAllXY(struct ListXY *pl);
+
+
+
+/** 
+ * Return the number of list in the 2 dimensions list
+ * 
+ * @param {struct ListXY *}    : refers to a 2 dimensions ball list (multiple draws)
+ * @return {Integer}           : Return the number of list in the 2 dimensions list
+ */
+UINTROW lengthY(struct ListXY *pl);
+
+
+
+/** 
+ * Find the pointer of the list at the end of the 2 dimensions list
  * 
  * @param {struct ListXY *}    : refers to a 2 dimensions ball list (multiple draws)
  * @return {struct ListX *}    : returns pointer of the list at the end of the 2 dimensions list
@@ -520,7 +1229,7 @@ void incVal2(struct ListX2 *pl, UINT8 ind);
  * @param {struct ListXY *}    : refers to a 2 dimensions ball list (luckyBalls)
  * @param {Integer} ind        : index of a list in the 2 dimensions ball list
  */
-void incValXY(struct ListXY *pl, UINT16 ind);
+void incValXY(struct ListXY *pl, UINTROW ind);
 
 
 
@@ -531,7 +1240,7 @@ void incValXY(struct ListXY *pl, UINT16 ind);
  * @param {Integer} ind        : index of a list in the 2 dimensions ball list
  * @return {Integer}           : Returns the value of the list at the specified index
  */
-UINT16 getValXY(struct ListXY *pl, UINT16 ind);
+UINTROW getValXY(struct ListXY *pl, UINTROW ind);
 
 
 
@@ -576,7 +1285,7 @@ void getKeys(struct ListX *pl, UINT8 *keys, UINT8 index, UINT8 count);
  * @param {Integer} ind        : index of 1 dimension list (a draw) in the 2 dimensions list (multi draws)
  * @return {struct ListX *}    : refers to a ball list at the specified index
  */
-struct ListX * getListXByIndex(struct ListXY *pl, UINT16 ind);
+struct ListX * getListXByIndex(struct ListXY *pl, UINTROW ind);
 
 
 
@@ -652,6 +1361,18 @@ void printListXYWithPNByKey(struct ListXY *pl1, struct ListXY *pl2, FILE *fp);
 
 
 
+/**
+ * Print a chunk of a large coupon to the output file
+ *
+ * @param {struct ListXY *} pl1   : refers to the 2 dimensions balls list (coupon chunk)
+ * @param {struct ListXY *} pl2   : refers to the 2 dimensions balls list (plus numbers of the coupon chunk)
+ * @param {Integer} firstRow      : rows written before the chunk
+ * @param {FILE *} fp             : refers to output file (or stdout)
+*/
+void printCouponRows(struct ListXY *pl1, struct ListXY *pl2, UINT32 firstRow, FILE *fp);
+
+
+
 /** 
  * How many times the balls has been drawn so far 
  * (assign values to winningBallsDrawCount and plusNumberBallsDrawCount global variables)
@@ -687,7 +1408,7 @@ void printLuckyBalls(struct ListXY *pl, FILE *fp);
  * @param {Integer}     : sum of numbers from 1 to n
  * @return {Integer}    : n
 */
-UINT16 numberOfTerm(UINT16 sum);
+UINTROW numberOfTerm(UINTROW sum);
 
 
 
@@ -704,6 +1425,8 @@ UINT16 numberOfTerm(UINT16 sum);
  * at the base of pascal's triangle. If a ball is dropped from the top node of Pascal's triangle, it drops to the left or right each time 
  * it hits the node (like tossing a coin). The gaussIndex function moves towards the base of the triangle, making a random selection at
  * each node. When it reaches the base of the triangle, it returns the index whichever node (index) it hits. 
+ * The probabilities of the indexes are calculated once for a ball count (createGaussTable), so an index is picked
+ * in constant time with the same distribution.
  * 
  * @param {Integer} ballCount      : Ball count in the globe
  * @return {Integer}               : Returns the random ball number (or ballSortOrder index, you substract 1 from the return value for index)
@@ -714,6 +1437,69 @@ UINT8 gaussIndex(UINT8 ballCount);
 
 
 
+/**
+ * Creates the alias table of gaussIndex for the ball count. The ball takes the right branch at a node with
+ * probability 0.505 (49 or 50 out of 100 for the left branch, evenly), so after ballCount-1 levels
+ * the probability of the index k+1 is C(ballCount-1, k) * 0.505^k * 0.495^(ballCount-1-k).
+ * 
+ * @param {Integer} ballCount      : Ball count in the globe
+ * @return {struct AliasTable *}   : Returns the alias table, NULL if memory could not be allocated
+ */
+struct AliasTable *createGaussTable(UINT8 ballCount);
+
+
+
+/**
+ * Seeds a random number stream. Streams of the same seed are independent (each one is 2^64 numbers ahead of the previous one).
+ * 
+ * @param {struct Random *} r       : refers to the random number generator state
+ * @param {Integer} seed            : seed
+ * @param {Integer} stream          : stream number (0 for the main stream)
+ */
+void seedRandom(struct Random *r, UINT32 seed, UINT32 stream);
+
+
+
+/**
+ * Jumps the stream 2^64 numbers ahead (the next stream of the same seed)
+ *
+ * @param {struct Random *} r       : refers to the random number generator state
+ */
+void jumpRandom(struct Random *r);
+
+
+
+/**
+ * Returns the next 32 bit random number of the stream
+ * 
+ * @param {struct Random *} r       : refers to the random number generator state
+ * @return {Integer}                : random number
+ */
+UINT32 nextRandom(struct Random *r);
+
+
+
+/**
+ * Returns a random number between 0 and n-1 (without modulo bias)
+ * 
+ * @param {struct Random *} r       : refers to the random number generator state
+ * @param {Integer} n               : count of the numbers
+ * @return {Integer}                : random number (0 if n is 0)
+ */
+UINT32 randomBelow(struct Random *r, UINT32 n);
+
+
+
+/**
+ * Returns a random number in [0, 1)
+ * 
+ * @param {struct Random *} r       : refers to the random number generator state
+ * @return {double}                 : random number
+ */
+double randomUnit(struct Random *r);
+
+
+
 /**
  * Draw random numbers
  * 
@@ -924,7 +1710,34 @@ UINT8 search2CombX(struct ListX *aPrvDrawn, struct ListX *drawnBalls, struct Lis
 
 
 /** 
- * The search1BallXY function searches for 1 ball in a draws list. 
+ * The searchCombX function searches for {comb} combinations in a previous draw.
+ * The common balls of the two draws are found by the ball bitmasks, so the combinations
+ * are enumerated only if the draws have at least {comb} balls in common.
+ * 
+ * @param {struct ListX *} aPrvDrawn      : refers to a drawn balls in the previous draws.
+ * @param {struct ListX *} drawnBalls     : refers to balls drawn in a new draw. 
+ * @param {struct ListXY *} luckyBalls    : If this parameter is not set to NULL, matching combinations are added to this list (lucky numbers)
+ * @param {char *} buf                    : If this parameter is not set to NULL, matching combinations are assigned to this address as string
+ * @param {Integer} comb                  : double, triple, quartet or quintuple combinations
+ * @return {Integer}                      : Returns the number of matching combinations (0 if not found).
+ */
+UINT8 searchCombX(struct ListX *aPrvDrawn, struct ListX *drawnBalls, struct ListXY *luckyBalls, char *buf, UINT8 comb);
+
+
+
+/** 
+ * Return the number of k combinations of n (n choose k)
+ * 
+ * @param {Integer} n       : number of items
+ * @param {Integer} k       : number of items in a combination
+ * @return {Integer}        : n choose k (0 if k > n)
+ */
+UINT32 combCount(UINT8 n, UINT8 k);
+
+
+
+/** 
+ * The search1BallXY function searches for 1 ball in a draws list. 
  *
  * @param {struct ListXY *} couponList    : refers to the balls has been new drawns. 
  * @param {struct ListX *} drawnBalls     : refers to balls drawn in a new draw. 
@@ -935,6 +1748,170 @@ UINT8 search1BallXY(struct ListXY *couponList, struct ListX *drawnBalls, UINT8 d
 
 
 
+/**
+ * Create the combination bitsets of a coupon
+ *
+ * @param {struct CouponIndex *} pi   : refers to a coupon index
+ * @param {Integer} totalBall         : total ball count
+ * @param {Integer} drawBallCount     : number of balls in a row
+ * @return {struct CouponIndex *}     : refers to the coupon index (memory allocated), NULL if there is not enough memory
+ */
+struct CouponIndex *createCouponIndex(struct CouponIndex *pi, UINT8 totalBall, UINT8 drawBallCount);
+
+
+
+/**
+ * Set or search the {comb} ball combinations of a row in the bitset
+ *
+ * @param {struct CouponIndex *} pi   : refers to a coupon index
+ * @param {struct ListX *} drawnBalls : refers to balls of a row
+ * @param {Integer} comb              : number of balls in a combination
+ * @param {Integer} add               : If 1 the combinations are set, if 0 they are searched
+ * @return {Integer}                  : Returns 1 if a combination is found (search), 0 otherwise
+ */
+UINT8 probeCouponIndex(struct CouponIndex *pi, struct ListX *drawnBalls, UINT8 comb, UINT8 add);
+
+
+
+/**
+ * Release the allocated memory of the coupon index
+ *
+ * @param {struct CouponIndex *} pi   : refers to a coupon index
+ */
+void removeCouponIndex(struct CouponIndex *pi);
+
+
+
+/**
+ * Clear the combinations of the coupon index (for a new coupon)
+ *
+ * @param {struct CouponIndex *} pi   : refers to a coupon index
+ */
+void clearCouponIndex(struct CouponIndex *pi);
+
+
+
+/**
+ * Searches the {comb} ball combinations of a new row in the coupon (in the coupon index if the coupon has one)
+ *
+ * @param {struct ListXY *} coupon    : refers to the coupon
+ * @param {struct ListX *} drawnBalls : refers to balls drawn in a new draw
+ * @param {Integer} drawBallCount     : number of balls in a row
+ * @param {Integer} comb              : 1 (a ball), 2, 3 or 4 combinations
+ * @return {Integer}                  : Returns 1 if found, 0 if not.
+ */
+UINT8 searchCoupon(struct ListXY *coupon, struct ListX *drawnBalls, UINT8 drawBallCount, UINT8 comb);
+
+
+
+/**
+ * Returns the row count of the coupon (rows of all the chunks if the coupon has an index)
+ *
+ * @param {struct ListXY *} coupon    : refers to the coupon
+ * @return {Integer}                  : row count
+ */
+UINT32 couponRows(struct ListXY *coupon);
+
+
+/**
+ * Create the lucky index of the lucky numbers list
+ *
+ * @param {struct LuckyIndex *} pi    : refers to a lucky index
+ * @param {struct ListXY *} luckyBalls : refers to the lucky numbers list (luckyBalls2, luckyBalls3 or luckyBalls4)
+ * @param {Integer} comb              : number of balls in a combination
+ * @param {Integer} totalBall         : total ball count
+ * @return {struct LuckyIndex *}      : refers to the lucky index (memory allocated), NULL if there is not enough memory
+ */
+struct LuckyIndex *createLuckyIndex(struct LuckyIndex *pi, struct ListXY *luckyBalls, UINT8 comb, UINT8 totalBall);
+
+
+
+/**
+ * Release the allocated memory of the lucky index
+ *
+ * @param {struct LuckyIndex *} pi    : refers to a lucky index
+ */
+void removeLuckyIndex(struct LuckyIndex *pi);
+
+
+
+/**
+ * Returns the slot of a combination in the lucky index
+ *
+ * @param {struct LuckyIndex *} pi    : refers to a lucky index
+ * @param {Integer *} balls           : sorted balls of the combination
+ * @param {Integer} add               : If 1 an empty slot is returned for a new combination
+ * @return {struct LuckyComb *}       : refers to the slot, NULL if the combination is not lucky
+ */
+struct LuckyComb *getLuckyComb(struct LuckyIndex *pi, UINT8 *balls, UINT8 add);
+
+
+
+/**
+ * Returns the slot of a combination in the lucky index by the rank of the combination
+ *
+ * @param {struct LuckyIndex *} pi    : refers to a lucky index
+ * @param {Integer} rank              : combination rank (colexicographic order of the sorted balls)
+ * @param {Integer} add               : If 1 an empty slot is returned for a new combination
+ * @return {struct LuckyComb *}       : refers to the slot, NULL if the combination is not lucky
+ */
+struct LuckyComb *getLuckyRank(struct LuckyIndex *pi, UINT32 rank, UINT8 add);
+
+
+
+/**
+ * Searches the {comb} ball combinations of the drawn balls in the lucky numbers (in the lucky index if there is one)
+ *
+ * @param {struct ListX *} drawnBalls : refers to balls drawn in a new draw
+ * @param {Integer} comb              : 2, 3 or 4 combinations
+ * @param {Integer *} due             : If not NULL, set to 1 if a found combination is due to be drawn again
+ *                                      (not drawn for its average days apart and drawn often enough), 0 otherwise
+ * @return {Integer}                  : Returns how many lucky combinations are found
+ */
+UINT8 searchLucky(struct ListX *drawnBalls, UINT8 comb, UINT8 *due);
+
+
+
+/**
+ * Eliminates the drawn balls by the lucky numbers. The lucky quartets (elimComb 4), triples (elimComb 3) and pairs are
+ * searched in turn, the drawn balls are eliminated if the first combinations found are not due to be drawn again.
+ *
+ * @param {struct ListX *} drawnBalls : refers to balls drawn in a new draw
+ * @param {Integer} elimComb          : largest combination searched (2, 3 or 4, 0 for none)
+ * @return {Integer}                  : Returns 1 if the drawn balls are eliminated, 0 if not.
+ */
+UINT8 elimByLucky(struct ListX *drawnBalls, UINT8 elimComb);
+
+
+/**
+ * Sort the lucky rows for drawBallsByLucky and gather the partners of the balls
+ *
+ * @param {struct LuckyPartners *} lp  : refers to the lucky partners
+ * @param {struct ListXY *} luckyBalls : refers to the lucky numbers list (pairs or triples)
+ * @param {Integer} comb               : number of balls in a lucky row (2 or 3)
+ * @param {Integer} totalBall          : total ball count
+ * @return {struct LuckyPartners *}    : refers to the lucky partners (memory allocated), NULL if the list is empty or there is not enough memory
+ */
+struct LuckyPartners *createLuckyPartners(struct LuckyPartners *lp, struct ListXY *luckyBalls, UINT8 comb, UINT8 totalBall);
+
+
+
+/**
+ * Release the allocated memory of the lucky partners
+ *
+ * @param {struct LuckyPartners *} lp  : refers to the lucky partners
+ */
+void removeLuckyPartners(struct LuckyPartners *lp);
+
+
+
+/**
+ * Compare function of qsort for the lucky rows (by days apart, by count and then by the balls)
+ */
+int compareLuckyRows(const void *p1, const void *p2);
+
+
+
 /** 
  * Matched combinations are assigned to {luckyBalls} and {buf}
  * 
@@ -961,8 +1938,10 @@ UINT8 init();
 /**
  * Calculate matching combinations count of numbers from previous draws
  * it prints the number of matching double, triple, quartet, quintuple, and six combinations.
+ *
+ * @return {Integer}                      : returns 1 if success, 0 if there is not enough memory
 */
-void calcMatchCombCount();
+UINT8 calcMatchCombCount();
 
 
 
@@ -979,17 +1958,114 @@ void calcMatchComb(UINT8 comb, FILE *fp);
 
 
 
+/**
+ * Print the draws that contain all of the numbers along with their dates and the days to the previous draw of the numbers
+ * 
+ * @param {UINT8 *} balls   : numbers (sorted)
+ * @param {Integer} count   : number of the numbers
+ * @param {Integer} printTo : 0: print to screen and output file. 2: print to output file only.
+ * @param {FILE *} fp       : refers to output file. If fp != NULL print to output file
+*/
+void queryDraws(UINT8 *balls, UINT8 count, UINT8 printTo, FILE *fp);
+
+
+
+/**
+ * Get the numbers of a query ("8,22,55,71", any character other than a digit separates the numbers)
+ * 
+ * @param {char *} s        : numbers
+ * @param {UINT8 *} balls   : sorted numbers are assigned to this address (DRAW_BALL items)
+ * @return {Integer}        : number of the numbers, 0 if a number is out of range or repeated or there are too many numbers
+*/
+UINT8 getQueryBalls(char *s, UINT8 *balls);
+
+
+
+/**
+ * Print the pairs of draws within some days of each other that have at least some common numbers (near-duplicate draws),
+ * along with the chance of the common numbers for two random draws, and the expected count of the near-duplicates
+ * 
+ * @param {Integer} days    : most days between the draws of a pair
+ * @param {Integer} overlap : least common numbers of a pair
+ * @param {FILE *} fp       : refers to output file
+*/
+void nearDuplicates(UINT32 days, UINT8 overlap, FILE *fp);
+
+
+
+/**
+ * Monte Carlo test of the draws. Random histories of as many draws are simulated and the statistics of the
+ * drawn balls table (evenness of the ball counts and matched combinations) are compared with their distribution
+ * for random draws, the share of the random histories as extreme as the draws is the p-value of a statistic.
+ * 
+ * @param {Integer} histories : number of the random histories
+ * @param {FILE *} fp         : refers to output file
+*/
+void monteCarlo(UINT32 histories, FILE *fp);
+
+
+
+/**
+ * Simulate the random histories of the Monte Carlo test until none is left. The history h is drawn with
+ * the stream h of the seed, so the results do not depend on the worker count.
+ * 
+ * @param {struct MonteCarlo *} pm : refers to the Monte Carlo test
+*/
+void simulateHistories(struct MonteCarlo *pm);
+
+
+
+/**
+ * Get the statistics of a history: the sum of the squares of the ball counts (the chi-square of the ball counts
+ * for a given number of draws), the most and least drawn counts, and the matched 2...DRAW_BALL combinations.
+ * A combination drawn f times matches in C(f,2) pairs of draws, so the matched k combinations are the sum of
+ * C(common numbers, k) over the pairs of draws.
+ * 
+ * @param {UINT8 *} balls     : balls of the draws (rows*DRAW_BALL items)
+ * @param {MASKWORD *} masks  : ball bitmasks of the draws (rows*MASK_WORDS items)
+ * @param {Integer} rows      : number of the draws
+ * @param {UINTSUM *} stats   : statistics are assigned to this address (SIMSTATS items)
+*/
+void getHistoryStats(UINT8 *balls, MASKWORD *masks, UINTROW rows, UINTSUM *stats);
+
+
+
 /**
  * Get the numbers that drawn together from winning numbers (lucky numbers)
  *
  * @param {struct ListXY *} luckyBalls    : refers to the lucky balls list
  * @param {Integer} comb                  : double, triple or quartet (2, 3 or 4) combinations
- * @return {struct ListXY *} luckyBalls   : refers to the lucky balls list
+ * @return {struct ListXY *} luckyBalls   : refers to the lucky balls list, NULL if there is not enough memory
 */
 struct ListXY * getLuckyBalls(struct ListXY *luckyBalls, UINT8 comb);
 
 
 
+/**
+ * Set the statistics (draw counts, lucky numbers, lucky index, dates and rows) from a window of the draws (--window).
+ * The draw counts of the balls and the pairs are the differences of the prefix counts, the triples and
+ * the quartets are counted over the rows of the window.
+ *
+ * @param {Integer} first                 : latest row of the window (0 is the latest draw)
+ * @param {Integer} last                  : oldest row of the window
+ * @return {Integer}                      : returns 1 if success, otherwise returns 0
+*/
+UINT8 setStatsWindow(UINTROW first, UINTROW last);
+
+
+
+/**
+ * Get the rows of a window of the draws from the --window option
+ *
+ * @param {char *} window                 : the latest draws ("100") or the years ("2019-2021")
+ * @param {UINTROW *} first               : latest row of the window is assigned to this address
+ * @param {UINTROW *} last                : oldest row of the window is assigned to this address
+ * @return {Integer}                      : returns 1 if there are draws in the window, otherwise returns 0
+*/
+UINT8 getWindowRows(char *window, UINTROW *first, UINTROW *last);
+
+
+
 /**
  * Save the numbers that drawn together to file
  * 
@@ -1044,3103 +2120,7083 @@ void drawBalls(struct ListXY *coupon, UINT8 totalBall, UINT8 drawBallCount, UINT
 
 
 
-/** 
- * Get drawn balls lists from file has been drawn so far
- * The lists is assigned to the global variables winningDrawnBallsList or plusNumberDrawnBallsList
- * 
- * @param {struct ListXY *}  : refer to 2 dimensions list of winning numbers (winningDrawnBallsList or plusNumberDrawnBallsList)
- * @param {char *}           : Drawn list file
- * @return {Integer}         : returns 0 if fileName or record not found, otherwise returns the number of records.
- */
-UINT16 getDrawnBallsList(struct ListXY *ballList, char *fileName);
+/**
+ * Draw a large coupon in chunks of LARGECHUNK rows and write every chunk as soon as it is drawn.
+ * The coupon is checked with the coupon index, so the memory used does not grow with the row count.
+ *
+ * @param {Integer} rowCount		: row count
+ * @param {FILE *} fp				: refers to output file (or stdout)
+*/
+void drawLargeCoupon(UINT32 rowCount, FILE *fp);
 
 
 
-/* FUNCTIONS */
+/**
+ * Score every combination of the balls and write the best tickets (--top)
+ *
+ * @param {Integer} topCount		: ticket count
+ * @param {FILE *} fp				: refers to output file (or stdout)
+*/
+void searchTopTickets(UINT32 topCount, FILE *fp);
 
 
-struct ListX *createListX(struct ListX *pl, UINT8 size, char *label, UINT16 val, UINT16 val2, UINT16 year, UINT8 mon, UINT8 day)
-{
-	pl = (struct ListX *) malloc(sizeof(struct ListX));
-	pl->balls = (UINT8 *) malloc(sizeof(UINT8)*size);
-	pl->next = NULL;
-	pl->label = NULL;
-    
-	if (label) {
-		pl->label = (char *) malloc(sizeof(char)*22);
-		strcpy(pl->label, label);
-	}
 
-	pl->index = 0;
-	pl->size = size;
-	pl->val = val;
-	pl->val2 = val2;
-	pl->year = year;
-	pl->mon = mon;
-	pl->day = day;
+/**
+ * Score the tickets of the first balls taken from the ticket search and keep the best ones in a heap
+ *
+ * @param {struct TopSearch *} ps	: refers to the ticket search
+ * @param {struct TopHeap *} ph		: refers to the best tickets of the worker
+*/
+void scoreTopTickets(struct TopSearch *ps, struct TopHeap *ph);
 
-	return pl;
-}
 
 
+/**
+ * Score the tickets starting with the given ball
+ *
+ * @param {struct TopSearch *} ps	: refers to the ticket search
+ * @param {struct TopHeap *} ph		: refers to the best tickets of the worker
+ * @param {Integer} first			: first (smallest) ball of the tickets
+*/
+void scoreTopTicketsFrom(struct TopSearch *ps, struct TopHeap *ph, UINT8 first);
 
-struct ListX2 *createListX2(struct ListX2 *pl, UINT8 size)
-{
-	pl = (struct ListX2 *) malloc(sizeof(struct ListX2));
-	pl->balls = (UINT8 *) malloc(sizeof(UINT8)*size);
-	pl->vals = (UINT16 *) malloc(sizeof(UINT16)*size);
 
-	pl->index = 0;
-	pl->size = size;
 
-	return pl;
-}
+/**
+ * Add a ticket to the heap if it is better than the worst ticket kept
+ *
+ * @param {struct TopHeap *} ph		: refers to the best tickets
+ * @param {Integer} score			: ticket score
+ * @param {UINT8 *} balls			: sorted balls of the ticket
+*/
+void addTopTicket(struct TopHeap *ph, SINT32 score, UINT8 *balls);
 
 
 
-struct ListXY *createListXY(struct ListXY *pl)
-{
-	pl = (struct ListXY *) malloc(sizeof(struct ListXY));
-	pl->list = NULL;
+/**
+ * Compare function of qsort for the tickets (by score and then by rank, best first)
+ */
+int compareTopTickets(const void *p1, const void *p2);
 
-	return pl;
-}
 
 
+/**
+ * Score the tickets of a file and write a score row for each ticket (--score). The balls of a line are the ticket,
+ * any character other than a digit separates the balls. A line with too many, too few or no balls is an invalid ticket,
+ * only the blank lines are skipped.
+ *
+ * @param {char *} fileName			: tickets file
+ * @param {FILE *} fp				: refers to output file (or stdout)
+ * @return {UINT32}					: number of the tickets scored, 0 if the file is not found
+*/
+UINT32 scoreTicketsFile(char *fileName, FILE *fp);
 
-void insertItem2(struct ListX2 *pl, UINT8 key)
-{
-	UINT8 i;
 
-	if (pl->index < pl->size) 
-	{
-		for (i=pl->index; i>0; i--) {
-			pl->balls[i] = pl->balls[i-1];
-		}
 
-		pl->balls[0] = key;
-		pl->index++;
-	}
-}
+/**
+ * Score a ticket by the draw counts of its balls and its lucky combinations
+ *
+ * @param {UINT8 *} balls			: sorted balls of the ticket
+ * @param {UINTROW *} ballDraws		: draw counts of the balls (ballDraws[ball])
+ * @param {UINT32 *} binom			: binomial coefficients, C(n,k) is binom[n*(DRAW_BALL+1)+k]
+ * @param {struct TicketScore *} ts	: the score is assigned to this address
+*/
+void scoreTicket(UINT8 *balls, UINTROW *ballDraws, UINT32 *binom, struct TicketScore *ts);
 
 
 
-struct ListX *atEndY(struct ListXY *pl)
-{
-	struct ListX *curr;
+/**
+ * Set the days since the lucky combinations of the ticket were last drawn if the combination is drawn later
+ *
+ * @param {struct TicketScore *} ts	: refers to the score of the ticket
+ * @param {Integer} comb			: 2, 3 or 4 combinations
+ * @param {struct LuckyComb *} lc	: refers to a lucky combination of the ticket
+*/
+void setTicketDays(struct TicketScore *ts, UINT8 comb, struct LuckyComb *lc);
 
-	if (pl == NULL)
-		return NULL;
 
-	curr = pl->list;
 
-	while (curr->next) {
-		curr = curr->next;
-	}
+/**
+ * Replay the latest draws one by one (--backtest). For every draw the statistics are set from the older draws only,
+ * BACKTESTROWS rows of each draw mode are drawn and the rows are scored with the balls of the draw. The draw counts
+ * and the combination counts are updated draw by draw from the oldest draw, so init is not repeated for a draw.
+ * The draws are shared by worker processes (the statistics are global), every draw has its own random number stream,
+ * so the results do not depend on the worker count.
+ *
+ * @param {Integer} draws			: number of the latest draws to be replayed
+ * @param {FILE *} fp				: refers to output file (or stdout)
+*/
+void backtest(UINTROW draws, FILE *fp);
 
-	return curr;
-}
 
 
+/**
+ * Replay the draws of the rows latest...oldest of the drawn balls table (the latest draw is row 0)
+ *
+ * @param {Integer} latest			: latest row to be replayed
+ * @param {Integer} oldest			: oldest row to be replayed
+ * @param {UINT32 *} hits			: rows of the draw modes by matched balls, hits[mode*(DRAW_BALL+1)+matched] (8*(DRAW_BALL+1) items)
+ * @return {Integer}				: returns 1 if success, 0 if there is not enough memory for the combination counts
+*/
+UINT8 backtestDraws(UINTROW latest, UINTROW oldest, UINT32 *hits);
 
-void appendItem(struct ListX *pl, UINT8 key)
-{
-	if (pl->index < pl->size) {
-		pl->balls[pl->index] = key;
-		pl->index++;
-	}
-}
 
 
+/**
+ * Write an unsigned number right aligned to a buffer
+ *
+ * @param {char *} buf				: refers to the buffer
+ * @param {Integer} num				: number
+ * @param {Integer} width			: width of the field
+ * @return {char *}					: refers to the end of the written number
+*/
+char *putNumber(char *buf, UINT32 num, UINT8 width);
 
-void appendItem2(struct ListX2 *pl, UINT8 key, UINT16 val)
-{
-	if (pl->index < pl->size) {
-		pl->balls[pl->index] = key;
-		pl->vals[pl->index] = val;
-		pl->index++;
-	}
-}
 
 
+#ifdef USE_THREADS
 
-void appendItems(struct ListX *pl, UINT8 *keys)
-{
-	UINT8 i, size = strlen((char *)keys);
-	
-	if (pl->index + size <= pl->size) 
-	{
-		for (i=0; i< size && keys[i] != '\0'; i++) {
-			pl->balls[pl->index+i] = keys[i];
-		}
+/**
+ * Draw balls by worker threads (drawBalls with --threads). The rows are drawn in the same order and with the same checks.
+ *
+ * @param {struct ListXY *} coupon			: refers to the 2 dimensions balls list (coupon)
+ * @param {struct ListX2 *} ballSortOrder	: ball sort order (draw counts of the balls)
+ * @param {char *} pLabel					: progress label
+ * @param {Integer} totalBall				: total ball count
+ * @param {Integer} drawBallCount			: number of balls to be drawn
+ * @param {Integer} drawRowCount			: how many draws will be made
+ * @param {Integer} numOfAttempts			: attempts of a row
+ * @param {Integer} drawByNorm...drawByLucky	: If 1 draw, if 0 don't draw.
+*/
+void drawBallsByWorkers(struct ListXY *coupon, struct ListX2 *ballSortOrder, char *pLabel, UINT8 totalBall, UINT8 drawBallCount, UINT8 drawRowCount, UINT8 numOfAttempts, UINT8 drawByNorm, UINT8 drawByLeft, UINT8 drawByBlend1, UINT8 drawByBlend2, UINT8 drawBySide, UINT8 drawByRand, UINT8 drawByLucky);
 
-		pl->index += size;
-	}
-}
 
 
+/**
+ * Sets a coupon row of drawBallsByWorkers and seeds its stream from the main stream
+ *
+ * @param {struct DrawJob *} job	: attempts shared with the workers
+ * @param {struct DrawRow *} row	: row to be set
+ * @param {Integer} mode			: DRAWBYNORM...DRAWBYLUCKY
+ * @param {Integer} j				: loop counter of drawBalls
+*/
+void setDrawRow(struct DrawJob *job, struct DrawRow *row, UINT8 mode, UINT8 j);
 
-void insertList(struct ListXY *pl, struct ListX *newList)
-{
-	newList->next = pl->list;
-	pl->list = newList;
-}
 
 
+/**
+ * Worker thread of drawBallsByWorkers. Draws the attempts of the round until none is left.
+ *
+ * @param {void *} arg		: refers to the job (struct DrawJob *)
+ * @return {void *}			: NULL
+*/
+void *drawWorker(void *arg);
 
-void appendList(struct ListXY *pl, struct ListX *plNext)
-{
-	if (pl == NULL) return;
 
-	if (pl->list == NULL) {
-		pl->list = plNext;
-	} else {
-		(atEndY(pl))->next = plNext;
-		plNext->next = NULL;
-	}
-}
 
+/**
+ * Worker thread of the ticket search
+ *
+ * @param {void *} arg		: refers to the ticket search (struct TopSearch)
+ * @return {void *}			: NULL
+*/
+void *topWorker(void *arg);
 
 
-UINT8 removeItemByIndex2(struct ListX2 *pl, UINT8 ind)
-{
-	UINT8 i, key = pl->balls[ind];
 
-	for(i=ind; i<pl->index; i++) {
-		pl->balls[i] = pl->balls[i+1];
-	}
+/**
+ * Worker thread of the Monte Carlo test
+ *
+ * @param {void *} arg		: refers to the Monte Carlo test (struct MonteCarlo)
+ * @return {void *}			: NULL
+*/
+void *simulateWorker(void *arg);
 
-	pl->balls[i] = '\0';
-	pl->index--;
 
-	return key;
-}
 
+/**
+ * Draws an attempt of a row with the stream of the attempt and checks it with the lucky balls
+ *
+ * @param {struct DrawJob *} job			: attempts shared with the workers
+ * @param {struct DrawRow *} row			: row of the attempt
+ * @param {Integer} i						: attempt
+ * @param {struct ListX *} drawnBalls		: balls list of the worker
+ * @param {struct ListX2 *} ballSortOrder	: ball sort order of the worker
+*/
+void drawAttempt(struct DrawJob *job, struct DrawRow *row, UINT8 i, struct ListX *drawnBalls, struct ListX2 *ballSortOrder);
 
+#endif
 
-struct ListX * removeListByIndex(struct ListXY *pl, UINT16 ind)
-{
-	struct ListX *prv, *pt = pl->list;
-	UINT16 i;
-	struct ListX *list;
 
-	if (pt) 
-	{
-		if (ind == 0) {
-			list = pt;
-			pl->list = pt->next;
-		} else {
-			for (i=1, prv=pt, pt=pt->next; (pt) && (i<ind); prv=prv->next, pt=pt->next, i++);
 
-			if (i == ind) {
-				list = pt;
-				prv->next = pt->next;
-			}
-		}
-	}
+/** 
+ * Get drawn balls lists from file has been drawn so far
+ * The winning numbers and the plus numbers are read together in one pass over the file
+ * 
+ * @param {struct TableXY *}	: refer to 2 dimensions table of winning numbers (winningDrawnBallsList) or NULL to skip them
+ * @param {struct TableXY *}	: refer to 2 dimensions table of plus numbers (plusNumberDrawnBallsList) or NULL to skip them
+ * @param {char *}			: Drawn list file
+ * @return {Integer}        : returns 0 if fileName or record not found, otherwise returns the number of records of the first table given.
+ */
+UINTROW getDrawnBallsList(struct TableXY *ballList, struct TableXY *bonusList, char *fileName);
 
-	return list;
-}
 
 
+/** 
+ * Map the file into memory (memory mapped on POSIX systems, read into a buffer otherwise)
+ *
+ * @param {char *} fileName     : file to be mapped
+ * @param {UINT32 *} length     : the length of the file is assigned to this address
+ * @return {char *}             : refers to the file contents, NULL if file not found or empty
+ */
+char *mapFile(char *fileName, UINT32 *length);
 
-struct ListXY * shuffleListXY(struct ListXY *pl)
-{
-	UINT16 i, index;
-	struct ListX *list;
-	UINT16 listLen = lengthY(pl);
-	UINT16 shuffleList = (UINT16) ((listLen * (rand() % 6 + (UINT16) ceil(listLen/2) - 5) * (rand() % 6 + (UINT16) ceil(listLen/3) - 5)));
 
-	for (i=0; i<shuffleList; i++)
-	{
-		index = rand() % listLen;
-		list = removeListByIndex(pl, index);
 
-		if (index < (UINT16) ceil(listLen/3)) {
-			insertList(pl, list);
-		}
-		else if (index < (UINT16) ceil(listLen/2)) {
-			addListByIndex(pl, list, (UINT16) ceil(2*listLen/3));
-		}
-		else if (index < (UINT16) ceil(2*listLen/3)) {
-			addListByIndex(pl, list, (UINT16) ceil(listLen/3));
-		}
-		else {
-			appendList(pl, list);
-		}
-	}
+/** 
+ * Release the file contents mapped by mapFile
+ *
+ * @param {char *} buf          : refers to the file contents
+ * @param {Integer} length      : length of the file
+ */
+void unmapFile(char *buf, UINT32 length);
 
-	return pl;
-}
 
 
+/** 
+ * Parse the numbers in a line of the statistics file (dates and balls). Any character other than
+ * a digit separates the numbers, so dd.mm.yyyy, yyyy-mm-dd and mm/dd/yyyy dates are all parsed as three numbers.
+ *
+ * @param {char **} pos         : refers to the position in the file contents, it is moved to the next line
+ * @param {char *} end          : end of the file contents
+ * @param {int *} fields        : parsed numbers are assigned to this array
+ * @param {Integer} maxFields   : size of the fields array
+ * @return {Integer}            : number of the parsed numbers
+ */
+UINT8 parseLine(char **pos, char *end, int *fields, UINT8 maxFields);
 
-UINT8 addItemByIndex2(struct ListX2 *pl, UINT8 ind, UINT8 key)
-{
-	UINT8 i;
 
-	if (pl->index < pl->size) 
-	{
-		for(i=pl->index; i>ind; i--) {
-			pl->balls[i] = pl->balls[i-1];
-		}
 
-		pl->balls[i] = key;
-		pl->index++;
-	} 
-	else {
-		return 0;
-	}
+#ifdef USE_SNAPSHOT
 
-	return 1;
-}
+/** 
+ * Return the FNV-1a hash of the buffer
+ *
+ * @param {char *} buf          : refers to the buffer
+ * @param {Integer} length      : length of the buffer
+ * @return {Integer}            : hash of the buffer
+ */
+UINT32 hashBuffer(char *buf, UINT32 length);
 
 
 
-void addListByIndex(struct ListXY *pl, struct ListX *newList, UINT16 ind)
-{
-	UINT16 i;
-	struct ListX *right = NULL, *left = pl->list;
+/** 
+ * Get the snapshot header of the statistics file (size, modification time and contents hash of the file)
+ *
+ * @param {char *} fileName                 : statistics file name
+ * @param {struct SnapshotHeader *} header  : the header is assigned to this address
+ * @return {Integer}                        : returns 1 if success, otherwise returns 0
+ */
+UINT8 getSnapshotHeader(char *fileName, struct SnapshotHeader *header);
 
-	if (left == NULL || ind == 0) 
-	{
-		pl->list = newList;
-		newList->next = left;
-	} 
-	else 
-	{
-		right = left->next;
 
-		for (i=1; i<ind; i++) {
-			if (left != NULL) left = left->next;
-			if (right != NULL) right = right->next;
-		}
 
-		if (left == NULL) return;
+/** 
+ * Copy bytes from the file contents and move the position after them
+ *
+ * @param {char **} pos         : refers to the position in the file contents
+ * @param {char *} end          : end of the file contents
+ * @param {void *} data         : bytes are copied to this address
+ * @param {Integer} size        : number of bytes
+ * @return {Integer}            : returns 1 if success, 0 if the file contents are too short
+ */
+UINT8 readBytes(char **pos, char *end, void *data, UINT32 size);
 
-		left->next = newList;
-		newList->next = right;
-	}
-}
 
 
+/** 
+ * Write the rows of the drawn balls table to the snapshot file
+ *
+ * @param {FILE *} fp           : refers to the snapshot file
+ * @param {struct TableXY *} pt : refers to a drawn balls table
+ * @return {Integer}            : returns 1 if success, otherwise returns 0
+ */
+UINT8 saveTableT(FILE *fp, struct TableXY *pt);
 
-void removeAllX(struct ListX *pl)
-{
-	UINT8 i;
 
-	for (i=0; i<pl->size; i++) {
-		pl->balls[i] = '\0';
-	}
-    
-	pl->index = 0;
-}
 
+/** 
+ * Read the rows of the drawn balls table from the snapshot file contents (bitmasks are rebuilt)
+ *
+ * @param {char **} pos         : refers to the position in the snapshot file contents
+ * @param {char *} end          : end of the snapshot file contents
+ * @param {struct TableXY *} pt : refers to an empty drawn balls table
+ * @return {Integer}            : returns 1 if success, otherwise returns 0
+ */
+UINT8 loadTableT(char **pos, char *end, struct TableXY *pt);
 
 
-void removeAllX2(struct ListX2 *pl)
-{
-	UINT8 i;
 
-	for (i=0; i<pl->size; i++) {
-		pl->balls[i] = '\0';
-		pl->vals[i] = '\0';
-	}
-    
-	pl->index = 0;
-}
+/** 
+ * Write the list (balls and how many times each ball has been drawn) to the snapshot file
+ *
+ * @param {FILE *} fp           : refers to the snapshot file
+ * @param {struct ListX2 *} pl  : refers to the list
+ * @return {Integer}            : returns 1 if success, otherwise returns 0
+ */
+UINT8 saveListX2(FILE *fp, struct ListX2 *pl);
 
 
 
-void removeAllXY(struct ListXY *pl)
-{
-	struct ListX *prvList, *pList = pl->list;
+/** 
+ * Read the list (balls and how many times each ball has been drawn) from the snapshot file contents
+ *
+ * @param {char **} pos         : refers to the position in the snapshot file contents
+ * @param {char *} end          : end of the snapshot file contents
+ * @param {struct ListX2 *} pl  : refers to an empty list
+ * @return {Integer}            : returns 1 if success, otherwise returns 0
+ */
+UINT8 loadListX2(char **pos, char *end, struct ListX2 *pl);
 
-	while (pList != NULL) 
-	{
-		prvList = pList;
-		pList = pList->next;
-		//removeAllX(prvList);
-		free(prvList->balls);
-		if (prvList->label) free(prvList->label);
-		free(prvList);
-	} 
 
-	pl->list = NULL;
-}
 
+/** 
+ * Write the 2 dimensions list (lucky numbers) to the snapshot file. Labels are not written.
+ *
+ * @param {FILE *} fp           : refers to the snapshot file
+ * @param {struct ListXY *} pl  : refers to the list
+ * @return {Integer}            : returns 1 if success, otherwise returns 0
+ */
+UINT8 saveListXY(FILE *fp, struct ListXY *pl);
 
 
-UINT16 lengthY(struct ListXY *pl)
-{
-	struct ListX *tmp = pl->list;
-	UINT16 i=0;
 
-	while (tmp)
-	{
-		i++;
-		tmp = tmp->next;
-	}
+/** 
+ * Read the 2 dimensions list (lucky numbers) from the snapshot file contents
+ *
+ * @param {char **} pos         : refers to the position in the snapshot file contents
+ * @param {char *} end          : end of the snapshot file contents
+ * @param {struct ListXY *} pl  : refers to an empty list
+ * @return {Integer}            : returns 1 if success, otherwise returns 0
+ */
+UINT8 loadListXY(char **pos, char *end, struct ListXY *pl);
 
-	return i;
-}
 
 
+/** 
+ * Return how many rows are added to the top of the table since the old table was read.
+ * The old rows must be the last rows of the table.
+ *
+ * @param {struct TableXY *} pt     : refers to the drawn balls table
+ * @param {struct TableXY *} old    : refers to the old drawn balls table
+ * @return {Integer}                : number of the new rows, -1 if the old rows are not the last rows of the table
+ */
+SINT32 newRowsT(struct TableXY *pt, struct TableXY *old);
 
-UINT8 seqSearchX(struct ListX *pl, UINT8 *keys, UINT8 size)
-{
-	UINT8 found=0;
-	UINT8 i, j;
 
-	for (i=0; i < pl->index -(size-1); i++) 
-	{
-		for (j=0; j < size; j++) {
-			if (pl->balls[i+j] == keys[j]) found++;
-		}
 
-		if (found == size) break;
-	}
+/** 
+ * Add the balls of the new rows to the ball draw counts
+ *
+ * @param {struct ListX2 *} pl  : refers to the ball draw counts (balls in ascending order)
+ * @param {struct TableXY *} pt : refers to the drawn balls table
+ * @param {Integer} newRows     : number of the new rows at the top of the table
+ */
+void updateBallCountX2(struct ListX2 *pl, struct TableXY *pt, UINTROW newRows);
 
-	return found;
-}
 
 
+/** 
+ * Add the matching combinations of the new rows and the older rows to the matching combination totals.
+ * Two draws having n balls in common match in C(n,comb) combinations.
+ *
+ * @param {UINT32 *} matchComb  : refers to the totals of the matching double, triple ... combinations
+ * @param {struct TableXY *} pt : refers to the drawn balls table
+ * @param {Integer} newRows     : number of the new rows at the top of the table
+ */
+void updateMatchComb(UINTSUM *matchComb, struct TableXY *pt, UINTROW newRows);
 
-int seqSearchX1(struct ListX *pl, UINT8 key)
-{
-	UINT8 i;
 
-	for (i=0; i<pl->index; i++) 
-	{
-		if (pl->balls[i] == key) return i;
-	}
 
-	return -1;
-}
+/** 
+ * Update the numbers that drawn together (lucky numbers) for the new rows. Only the combinations
+ * of the new rows are counted again over the table, the other combinations keep their counts and order.
+ *
+ * @param {struct ListXY *} pl  : refers to the lucky numbers list of the old rows
+ * @param {struct TableXY *} pt : refers to the drawn balls table
+ * @param {Integer} newRows     : number of the new rows at the top of the table
+ * @param {Integer} comb        : double, triple or quartet (2, 3 or 4) combinations
+ * @param {Integer} totalBall   : total ball count
+ * @return {Integer}            : returns 1 if success, otherwise returns 0
+ */
+UINT8 updateCombCountList(struct ListXY *pl, struct TableXY *pt, UINTROW newRows, UINT8 comb, UINT8 totalBall);
 
 
 
-int seqSearchX2(struct ListX2 *pl, UINT8 key)
-{
-	UINT8 i;
+/** 
+ * Save the drawn balls, ball draw counts, lucky numbers and matching combinations to the snapshot file
+ * of the statistics file. The header is completed after everything else is written,
+ * so a partially written snapshot is never loaded.
+ *
+ * @param {char *} fileName     : statistics file name
+ * @return {Integer}            : returns 1 if success, otherwise returns 0
+ */
+UINT8 saveSnapshot(char *fileName);
 
-	for (i=0; i<pl->index; i++) 
-	{
-		if (pl->balls[i] == key) return i;
+
+
+/** 
+ * Load the drawn balls, ball draw counts, lucky numbers and matching combinations from the snapshot file
+ * of the statistics file. Tables and lists must be created and empty. If new draws are added to the top of
+ * the statistics file, the statistics are updated for the new draws and the snapshot is rewritten.
+ * If the snapshot is missing, out of date or damaged, they are left empty and 0 is returned.
+ *
+ * @param {char *} fileName     : statistics file name
+ * @return {Integer}            : returns 1 if the snapshot is loaded, otherwise returns 0
+ */
+UINT8 loadSnapshot(char *fileName);
+
+#endif
+
+
+
+/* FUNCTIONS */
+
+
+struct ListX *createListX(struct ListX *pl, UINT8 size, char *label, UINTROW val, UINTDAY val2, UINT16 year, UINT8 mon, UINT8 day)
+{
+	pl = (struct ListX *) malloc(sizeof(struct ListX));
+	pl->balls = (UINT8 *) malloc(sizeof(UINT8)*size);
+	pl->next = NULL;
+	pl->label = NULL;
+    
+	if (label) {
+		pl->label = (char *) malloc(sizeof(char)*22);
+		strcpy(pl->label, label);
 	}
 
-	return -1;
+	pl->index = 0;
+	pl->size = size;
+	pl->val = val;
+	pl->val2 = val2;
+	pl->year = year;
+	pl->mon = mon;
+	pl->day = day;
+	pl->epochDay = getEpochDay(day, mon, year);
+
+	return pl;
 }
 
 
 
-int seqSearchXY(struct ListXY *pl, UINT8 *keys, UINT8 size)
+struct ListX2 *createListX2(struct ListX2 *pl, UINT8 size)
 {
-	struct ListX *tmp = pl->list;
-	UINT16 i=0;
+	pl = (struct ListX2 *) malloc(sizeof(struct ListX2));
+	pl->balls = (UINT8 *) malloc(sizeof(UINT8)*size);
+	pl->vals = (UINTROW *) malloc(sizeof(UINTROW)*size);
 
-	while (tmp)
-	{
-		if (seqSearchX(tmp, keys, size) == size) break;
-		tmp = tmp->next;
-		i++;
-	}
+	pl->index = 0;
+	pl->size = size;
 
-	if (tmp) return i;
-	else return -1;
+	return pl;
 }
 
 
 
-void incVal2(struct ListX2 *pl, UINT8 ind)
+struct ListXY *createListXY(struct ListXY *pl)
 {
-    pl->vals[ind]++;
-}
+	pl = (struct ListXY *) malloc(sizeof(struct ListXY));
+	pl->list = NULL;
+	pl->couponIndex = NULL;
 
+	return pl;
+}
 
 
-void incValXY(struct ListXY *pl, UINT16 ind)
+struct TableXY *createTableXY(struct TableXY *pt, UINT8 cols, UINTROW size)
 {
-	struct ListX *tmp = pl->list;
-	UINT16 i;
+	pt = (struct TableXY *) malloc(sizeof(struct TableXY));
 
-	for (i=0; (tmp) && i<ind; i++) 
-	{
-		tmp=tmp->next;
-	}
+	if (size == 0) size = 1;
 
-	tmp->val++;
+	pt->balls = (UINT8 *) malloc(sizeof(UINT8)*cols*(UINT32) size);
+	pt->mask = (MASKWORD *) malloc(sizeof(MASKWORD)*MASK_WORDS*(UINT32) size);
+	pt->year = (UINT16 *) malloc(sizeof(UINT16)*size);
+	pt->mon = (UINT8 *) malloc(sizeof(UINT8)*size);
+	pt->day = (UINT8 *) malloc(sizeof(UINT8)*size);
+	pt->epochDay = (UINT32 *) malloc(sizeof(UINT32)*size);
+
+	pt->rows = 0;
+	pt->size = size;
+	pt->cols = cols;
+
+	return pt;
 }
 
 
 
-UINT16 getValXY(struct ListXY *pl, UINT16 ind)
+UINT8 appendRowT(struct TableXY *pt, UINT8 *keys, UINT16 year, UINT8 mon, UINT8 day)
 {
-	struct ListX *tmp = pl->list;
-	UINT16 i;
+	UINT8 i;
+	UINTROW size;
+	UINT8 *balls;
+	MASKWORD *mask;
+	UINT16 *years;
+	UINT8 *mons, *days;
+	UINT32 *epochDays;
 
-	for (i=0; (tmp) && i<ind; i++) 
+	if (pt->rows == pt->size) 
 	{
-		tmp=tmp->next;
+		if (pt->size == UINTROWMAX) return 0;
+
+		if (pt->size == 0) size = 64;
+		else if (pt->size > UINTROWMAX/2) size = UINTROWMAX;
+		else size = pt->size*2;
+
+		balls = (UINT8 *) realloc(pt->balls, sizeof(UINT8)*pt->cols*(UINT32) size);
+		if (balls == NULL) return 0;
+		pt->balls = balls;
+
+		mask = (MASKWORD *) realloc(pt->mask, sizeof(MASKWORD)*MASK_WORDS*(UINT32) size);
+		if (mask == NULL) return 0;
+		pt->mask = mask;
+
+		years = (UINT16 *) realloc(pt->year, sizeof(UINT16)*size);
+		if (years == NULL) return 0;
+		pt->year = years;
+
+		mons = (UINT8 *) realloc(pt->mon, sizeof(UINT8)*size);
+		if (mons == NULL) return 0;
+		pt->mon = mons;
+
+		days = (UINT8 *) realloc(pt->day, sizeof(UINT8)*size);
+		if (days == NULL) return 0;
+		pt->day = days;
+
+		epochDays = (UINT32 *) realloc(pt->epochDay, sizeof(UINT32)*size);
+		if (epochDays == NULL) return 0;
+		pt->epochDay = epochDays;
+
+		pt->size = size;
 	}
 
-	return tmp->val;
+	balls = pt->balls + (UINT32) pt->rows*pt->cols;
+
+	for (i=0; i<pt->cols; i++) {
+		balls[i] = keys[i];
+	}
+
+	setMaskX(pt->mask + (UINT32) pt->rows*MASK_WORDS, balls, pt->cols);
+
+	pt->year[pt->rows] = year;
+	pt->mon[pt->rows] = mon;
+	pt->day[pt->rows] = day;
+	pt->epochDay[pt->rows] = getEpochDay(day, mon, year);
+	pt->rows++;
+
+	return 1;
 }
 
 
 
-UINT8 getKey(struct ListX *pl, UINT8 index)
+UINT8 *getRowT(struct TableXY *pt, UINTROW ind)
 {
-	return pl->balls[index];
+	return pt->balls + (UINT32) ind*pt->cols;
 }
 
 
 
-UINT8 getKey2(struct ListX2 *pl, UINT8 index)
+struct ListX *getListXByRow(struct TableXY *pt, UINTROW ind, struct ListX *pl)
 {
-	return pl->balls[index];
+	pl->balls = pt->balls + (UINT32) ind*pt->cols;
+	pl->label = NULL;
+	pl->year = pt->year[ind];
+	pl->mon = pt->mon[ind];
+	pl->day = pt->day[ind];
+	pl->epochDay = pt->epochDay[ind];
+	pl->val = 0;
+	pl->val2 = 0;
+	pl->index = pt->cols;
+	pl->size = pt->cols;
+	pl->next = NULL;
+
+	return pl;
 }
 
 
 
-void getKeys(struct ListX *pl, UINT8 *keys, UINT8 index, UINT8 count)
+void removeAllT(struct TableXY *pt)
 {
-	UINT8 i, j;
+	if (pt == NULL) return;
+
+	free(pt->balls);
+	free(pt->mask);
+	free(pt->year);
+	free(pt->mon);
+	free(pt->day);
+	free(pt->epochDay);
+
+	pt->balls = NULL;
+	pt->mask = NULL;
+	pt->year = NULL;
+	pt->mon = NULL;
+	pt->day = NULL;
+	pt->epochDay = NULL;
+	pt->rows = 0;
+	pt->size = 0;
+}
 
-	if (count == 0) count = pl->index;
 
-	for (i=index, j=0; j<count; i++, j++) 
-	{
-		keys[j] = pl->balls[i];
+
+void setMaskX(MASKWORD *mask, UINT8 *balls, UINT8 count)
+{
+	UINT8 i, bit;
+
+	for (i=0; i<MASK_WORDS; i++) {
+		mask[i] = 0;
 	}
 
-	keys[j] = '\0';
+	for (i=0; i<count; i++) 
+	{
+		if (balls[i] == 0 || balls[i] > MASK_WORDS*MASK_BITS) continue;
+
+		bit = balls[i] - 1;
+		mask[bit / MASK_BITS] |= (MASKWORD) 1 << (bit % MASK_BITS);
+	}
 }
 
 
 
-struct ListX * getListXByIndex(struct ListXY *pl, UINT16 ind)
+UINT8 popCountMask(MASKWORD *mask1, MASKWORD *mask2)
 {
-	struct ListX *l = pl->list;
-	UINT16 i;
+	UINT8 i, count = 0;
+	MASKWORD x;
 
-	for (i=0; (l) && i<ind; i++) 
+	for (i=0; i<MASK_WORDS; i++) 
 	{
-		l = l->next;
+		x = mask1[i] & mask2[i];
+
+		#if defined(__GNUC__) && !defined(__MSDOS__)
+		count += (UINT8) __builtin_popcountll(x);
+		#else
+		while (x) {
+			x &= x - 1;
+			count++;
+		}
+		#endif
 	}
 
-	return l;
+	return count;
 }
 
 
 
-void bubbleSortX2ByVal(struct ListX2 *pl, int inc)
+UINT8 overlapCountT(struct TableXY *pt, UINTROW ind1, UINTROW ind2)
 {
-	UINT8 i;
-	UINT8 tmp, swapped;
-	UINT16 tmp2;
+	return popCountMask(pt->mask + (UINT32) ind1*MASK_WORDS, pt->mask + (UINT32) ind2*MASK_WORDS);
+}
 
-	if (pl->index < 2) return;
 
-	do {
-		swapped = 0;
 
-		for (i=0; i < pl->index -1; i++)
-		{
-			if ((inc == 1 && pl->vals[i] > pl->vals[i+1]) || (inc == -1 && pl->vals[i] < pl->vals[i+1])) 
-			{
-				tmp = pl->balls[i];
-				pl->balls[i] = pl->balls[i+1];
-				pl->balls[i+1] = tmp;
+struct CombTable *createCombTable(struct CombTable *pc, UINT8 comb, UINT8 totalBall, UINT32 maxItems)
+{
+	UINT32 i;
 
-				tmp2 = pl->vals[i];
-				pl->vals[i] = pl->vals[i+1];
-				pl->vals[i+1] = tmp2;
+	if ((pc = (struct CombTable *) malloc(sizeof(struct CombTable))) == NULL) return NULL;
 
-				swapped = 1;
-			}
-		}
-	} while (swapped);
-}
+	pc->comb = comb;
+	pc->used = 0;
 
+	if (comb <= 2) {
+		pc->dense = 1;
+		pc->size = combCount(totalBall, 2);
+	} else {
+		pc->dense = 0;
 
+		/* there are no more different combinations than C(totalBall,comb) */
+		if (maxItems > combCount(totalBall, comb)) maxItems = combCount(totalBall, comb);
 
-void bubbleSortYByVal(struct ListXY *pl, int inc)
-{
-	UINT8 swapped;
-	struct ListX *ptr1;
-	struct ListX *lptr = NULL;
+		for (pc->size = 64; pc->size/2 < maxItems && pc->size < COMBTABLEMAX; pc->size *= 2);
+	}
 
-	if (pl->list == NULL) return;
+	if ((size_t) pc->size > ((size_t) -1) / sizeof(struct CombCount) 
+		|| (pc->items = (struct CombCount *) malloc(sizeof(struct CombCount)*pc->size)) == NULL) 
+	{
+		free(pc);
+		return NULL;
+	}
 
-	do {
-		swapped = 0;
-		ptr1 = pl->list;
+	for (i=0; i<pc->size; i++) {
+		pc->items[i].count = 0;
+	}
 
-		while (ptr1->next != lptr)
-		{
-			if ((inc == 1 && ptr1->val > ptr1->next->val) || (inc == -1 && ptr1->val < ptr1->next->val)) {
-				swapY(ptr1, ptr1->next);
-				swapped = 1;
-			}
-			ptr1 = ptr1->next;
-		}
+	return pc;
+}
 
-		lptr = ptr1;
 
-	} while (swapped);
+
+UINT32 combRank(UINT8 *balls, UINT8 comb)
+{
+	UINT32 rank = 0;
+	UINT8 i;
+
+	for (i=0; i<comb; i++) {
+		rank += combCount(balls[i]-1, i+1);
+	}
+
+	return rank;
 }
 
 
 
-void bubbleSortYByVal2(struct ListXY *pl, int inc)
+struct CombCount *getCombCount(struct CombTable *pc, UINT8 *balls)
 {
-	UINT8 swapped;
-	struct ListX *ptr1;
-	struct ListX *lptr = NULL;
+	UINT32 rank, slot;
+	UINT8 i;
 
-	if (pl->list == NULL) return;
+	if (pc->size == 0) return NULL;
 
-	do {
-		swapped = 0;
-		ptr1 = pl->list;
+	rank = combRank(balls, pc->comb);
 
-		while (ptr1->next != lptr)
-		{
-			if ((inc == 1 && ptr1->val2 > ptr1->next->val2) || (inc == -1 && ptr1->val2 < ptr1->next->val2)) {
-				swapY(ptr1, ptr1->next);
-				swapped = 1;
-			}
-			ptr1 = ptr1->next;
+	if (pc->dense) {
+		if (rank >= pc->size) return NULL;
+		slot = rank;
+	} else {
+		slot = rank ^ (rank >> 16);
+		slot *= 0x45d9f3bUL;
+		slot ^= slot >> 16;
+		slot &= pc->size-1;
+
+		while (pc->items[slot].count && pc->items[slot].rank != rank) {
+			slot = (slot+1) & (pc->size-1);
 		}
+	}
 
-		lptr = ptr1;
+	if (pc->items[slot].count == 0)
+	{
+		if (pc->used+1 >= pc->size && !pc->dense) return NULL;
 
-	} while (swapped);
+		pc->items[slot].rank = rank;
+
+		for (i=0; i<DRAW_BALL; i++) {
+			pc->items[slot].balls[i] = i < pc->comb ? balls[i] : 0;
+		}
+
+		pc->used++;
+	}
+
+	return &pc->items[slot];
 }
 
 
 
-void bubbleSortXByKey(struct ListX *pl)
+UINT8 countCombT(struct TableXY *pt, struct CombTable *pc)
 {
-	UINT8 i;
-	UINT8 tmp, swapped;
+	UINTROW r;
+	UINT8 balls[DRAW_BALL+1];
+	UINT8 comb[DRAW_BALL+1];
+	UINT8 pos[DRAW_BALL+1];
+	UINT8 i, j, n, tmp;
+	UINT8 full = 0;
+	struct CombCount *cc;
 
-	if (pl->index < 2) return;
+	n = pt->cols < DRAW_BALL ? pt->cols : DRAW_BALL;
 
-	do {
-		swapped = 0;
+	if (pc->comb == 0 || pc->comb > n) return 1;
 
-		for (i=0; i < pl->index -1; i++)
-		{
-			if (pl->balls[i] > pl->balls[i+1]) {
-				tmp = pl->balls[i];
-				pl->balls[i] = pl->balls[i+1];
-				pl->balls[i+1] = tmp;
-				swapped = 1;
-			}
+	for (r=0; r<pt->rows; r++)
+	{
+		for (i=0; i<n; i++) {
+			balls[i] = pt->balls[(UINT32) r*pt->cols + i];
 		}
-	} while (swapped);
-}
 
+		for (i=1; i<n; i++) {
+			for (j=i; j>0 && balls[j-1] > balls[j]; j--) {
+				tmp = balls[j];
+				balls[j] = balls[j-1];
+				balls[j-1] = tmp;
+			}
+		}
 
+		for (i=0; i<pc->comb; i++) {
+			pos[i] = i;
+		}
 
-void swapY(struct ListX *a, struct ListX *b)
-{
-	char *label;
-	UINT8 *balls;
-	UINT8 day, mon;
-	UINT16 year, val, val2;
+		while (1)
+		{
+			for (i=0; i<pc->comb; i++) {
+				comb[i] = balls[pos[i]];
+			}
 
-	balls = a->balls;
-	a->balls = b->balls;
-	b->balls = balls;
+			if ((cc = getCombCount(pc, comb)) != NULL) 
+			{
+				if (cc->count == 0) cc->first = r;
+				else if (cc->count == 1) cc->second = r;
 
-	label = a->label;
-	a->label = b->label;
-	b->label = label;
+				cc->last = r;
+				if (cc->count < UINTROWMAX) cc->count++;
+			}
+			else full = 1;
 
-	day = a->day;
-	a->day = b->day;
-	b->day = day;
+			for (i=pc->comb; i>0 && pos[i-1] == n-pc->comb+i-1; i--);
 
-	mon = a->mon;
-	a->mon = b->mon;
-	b->mon = mon;
+			if (i == 0) break;
 
-	year = a->year;
-	a->year = b->year;
-	b->year = year;
+			pos[i-1]++;
 
-	val = a->val;
-	a->val = b->val;
-	b->val = val;
+			for (; i<pc->comb; i++) {
+				pos[i] = pos[i-1] + 1;
+			}
+		}
+	}
 
-	val2 = a->val2;
-	a->val2 = b->val2;
-	b->val2 = val2;
+	return !full;
 }
 
 
 
-void printListXByKey(struct ListX *pl, UINT8 printTo, FILE *fp)
+UINT8 countCombRowT(struct TableXY *pt, struct CombTable *pc, UINTROW r)
 {
-	UINT8 i;
-	char buf[5];
+	UINT8 balls[DRAW_BALL+1];
+	UINT8 comb[DRAW_BALL+1];
+	UINT8 pos[DRAW_BALL+1];
+	UINT8 i, j, n, tmp;
+	UINT8 full = 0;
+	struct CombCount *cc;
 
-	for (i=0; i < pl->index; i++) 
+	n = pt->cols < DRAW_BALL ? pt->cols : DRAW_BALL;
+
+	if (pc->comb == 0 || pc->comb > n) return 1;
+
+	for (i=0; i<n; i++) {
+		balls[i] = pt->balls[(UINT32) r*pt->cols + i];
+	}
+
+	for (i=1; i<n; i++) {
+		for (j=i; j>0 && balls[j-1] > balls[j]; j--) {
+			tmp = balls[j];
+			balls[j] = balls[j-1];
+			balls[j-1] = tmp;
+		}
+	}
+
+	for (i=0; i<pc->comb; i++) {
+		pos[i] = i;
+	}
+
+	while (1)
 	{
-		sprintf(buf, "%2d ", pl->balls[i]);
-		// If printTo == 0 print to screen and output file, 1: print to screen only, 2: print to output file only
-		if (printTo == 0 || printTo == 1) {
-			printf("%s", buf);
+		for (i=0; i<pc->comb; i++) {
+			comb[i] = balls[pos[i]];
 		}
-		if ((printTo == 0 || printTo == 2) && fp != NULL) {
-			fputs(buf, fp);
+
+		if ((cc = getCombCount(pc, comb)) != NULL) 
+		{
+			if (cc->count == 0) cc->last = r;
+			else cc->second = cc->first;
+
+			cc->first = r;
+			if (cc->count < UINTROWMAX) cc->count++;
+		}
+		else full = 1;
+
+		for (i=pc->comb; i>0 && pos[i-1] == n-pc->comb+i-1; i--);
+
+		if (i == 0) break;
+
+		pos[i-1]++;
+
+		for (; i<pc->comb; i++) {
+			pos[i] = pos[i-1] + 1;
 		}
 	}
+
+	return !full;
 }
 
 
 
-void printListXYWithPNByKey(struct ListXY *pl1, struct ListXY *pl2, FILE *fp)
+struct PrefixCounts *createPrefixCounts(struct PrefixCounts *pp, struct TableXY *pt, UINT8 totalBall)
 {
-	struct ListX *nl1 = pl1->list;
-	struct ListX *nl2 = pl2->list;
-	char ioBuf[60];
-	char buf[30];
-	UINT8 i, j;
+	UINTROW *prev, *row;
+	UINTROW r;
+	UINT32 i;
+	UINT8 balls[2];
+	UINT8 j, k;
 
-	puts("     Numbers       + Number\n");
-	if (fp != NULL) fputs("     Numbers       + Number\n\n", fp);
+	if ((pp = (struct PrefixCounts *) malloc(sizeof(struct PrefixCounts))) == NULL) return NULL;
 
-	for (i=1; (nl1) && (nl2); i++)
+	pp->rows = pt->rows;
+	pp->totalBall = totalBall;
+	pp->pairCount = combCount(totalBall, 2);
+	pp->balls = (UINTROW *) calloc(((size_t) pt->rows+1) * (totalBall+1), sizeof(UINTROW));
+	pp->pairs = ((UINT32) pt->rows+1 > PREFIXMAX / pp->pairCount) ? NULL : (UINTROW *) malloc(((size_t) pt->rows+1) * pp->pairCount * sizeof(UINTROW));
+
+	if (pp->balls == NULL) {
+		removePrefixCounts(pp);
+		return NULL;
+	}
+
+	for (r=0; r < pt->rows; r++)
 	{
-		ioBuf[0] = '\0';
+		prev = pp->balls + (size_t) r*(totalBall+1);
+		row = prev + (totalBall+1);
 
-		sprintf(buf, "%2d - ", i);
-		strcat(ioBuf, buf);
+		for (i=0; i <= totalBall; i++) {
+			row[i] = prev[i];
+		}
 
-		for (j=0; j < nl1->index; j++) {
-			sprintf(buf, "%2d ", nl1->balls[j]);
-			strcat(ioBuf, buf);
+		for (j=0; j < pt->cols; j++) {
+			row[pt->balls[(UINT32) r*pt->cols + j]]++;
 		}
+	}
 
-		strcat(ioBuf, "  ");
+	/* the pairs are counted by the window rows if there is not enough memory */
 
-		for (j=0; j < nl2->index; j++) {
-			sprintf(buf, "%2d ", nl2->balls[j]);
-			strcat(ioBuf, buf);
-		}
+	if (pp->pairs == NULL) return pp;
 
-		if (nl1->label) {
-			sprintf(buf, "     %s", nl1->label);
-			strcat(ioBuf, buf);
+	for (i=0; i < pp->pairCount; i++) {
+		pp->pairs[i] = 0;
+	}
+
+	for (r=0; r < pt->rows; r++)
+	{
+		prev = pp->pairs + (size_t) r*pp->pairCount;
+		row = prev + pp->pairCount;
+
+		for (i=0; i < pp->pairCount; i++) {
+			row[i] = prev[i];
 		}
 
-		nl1 = nl1->next;
-		nl2 = nl2->next;
+		for (j=0; j < pt->cols; j++) 
+		{
+			for (k=j+1; k < pt->cols; k++) 
+			{
+				balls[0] = pt->balls[(UINT32) r*pt->cols + j];
+				balls[1] = pt->balls[(UINT32) r*pt->cols + k];
 
-		strcat(ioBuf, "\n");
+				if (balls[0] > balls[1]) {
+					balls[0] = balls[1];
+					balls[1] = pt->balls[(UINT32) r*pt->cols + j];
+				}
 
-		printf("%s", ioBuf);
-		if (fp != NULL) fputs(ioBuf, fp);
+				row[combRank(balls, 2)]++;
+			}
+		}
 	}
+
+	return pp;
 }
 
 
 
-void printDrawnBallCount(struct ListX2 *ballSortOrder)
+void removePrefixCounts(struct PrefixCounts *pp)
 {
-	UINT8 i;
+	if (pp == NULL) return;
 
-#ifdef __MSDOS__
-	UINT8 col = 10;
-#else
-	UINT8 col = 15;
-#endif
+	if (pp->balls) free(pp->balls);
+	if (pp->pairs) free(pp->pairs);
+	free(pp);
+}
 
-	for (i=0; i < ballSortOrder->index; i++) 
+
+
+UINTROW getPrefixRow(struct PrefixCounts *pp, UINT32 rank, UINTROW first, UINTROW last, UINTROW n)
+{
+	UINTROW lo = first, hi = last, mid;
+	UINTROW base = pp->pairs[(size_t) first*pp->pairCount + rank];
+
+	/* the first row r with n draws of the pair in the rows first...r */
+
+	while (lo < hi) 
 	{
-		printf("%2d:%3d", ballSortOrder->balls[i], ballSortOrder->vals[i]);
+		mid = lo + (hi-lo)/2;
 
-		if ((i+1) % col == 0) puts("");
-		else printf("  ");
+		if (pp->pairs[((size_t) mid+1)*pp->pairCount + rank] - base >= n) hi = mid;
+		else lo = mid+1;
 	}
+
+	return lo;
 }
 
 
 
-void printLuckyBalls(struct ListXY *pl, FILE *fp)
+struct BallPostings *createBallPostings(struct BallPostings *pp, struct TableXY *pt, UINT8 totalBall)
 {
-	struct ListX *nl = NULL;
-	UINT16 i = 0;
-	UINT8 j;
-	UINT8 col, len;
-	char ioBuf[50];
-	char buf[20];
+	UINTROW r;
+	UINT8 j, ball;
 
-	 if (pl == NULL || pl->list == NULL) 
-	 {
-		puts("No matched found.\n");
-		if (fp != NULL) fputs("No matched found.\n", fp);
+	if ((pp = (struct BallPostings *) malloc(sizeof(struct BallPostings))) == NULL) return NULL;
 
-		return;
-	 }
+	pp->rows = pt->rows;
+	pp->totalBall = totalBall;
+	pp->words = ((UINT32) pt->rows + MASK_BITS - 1) / MASK_BITS;
 
-	nl = pl->list;
-	len = nl->index;
+	if (pp->words == 0) pp->words = 1;
 
-#ifdef __MSDOS__
-	col = 6-len;
-	if (col<3) col = 3;
-#else
-	col = 8-len;
-#endif
+	if ((pp->bits = (MASKWORD *) calloc((UINT32) (totalBall+1) * pp->words, sizeof(MASKWORD))) == NULL) {
+		free(pp);
+		return NULL;
+	}
 
-	while (nl)
+	for (r=0; r < pt->rows; r++)
 	{
-		ioBuf[0] = '\0';
-		
-		for (j=0; j < nl->index; j++) {
-			sprintf(buf, "%2d ", nl->balls[j]);
-			strcat(ioBuf, buf);
+		for (j=0; j < pt->cols; j++) 
+		{
+			ball = pt->balls[(UINT32) r*pt->cols + j];
+			if (ball == 0 || ball > totalBall) continue;
+
+			pp->bits[(UINT32) ball*pp->words + r / MASK_BITS] |= (MASKWORD) 1 << (r % MASK_BITS);
 		}
+	}
 
-		sprintf(buf, ": %2d times", nl->val);
-		strcat(ioBuf, buf);
+	return pp;
+}
 
-		if ((i+1) % col == 0) {
-			strcat(ioBuf, "\n");
-		} else {
-			strcat(ioBuf, "    ");
-		}
 
-		i++;
-		nl = nl->next;
 
-		printf("%s", ioBuf);
-		if (fp != NULL) fprintf(fp, "%s", ioBuf);
-	}
+void removeBallPostings(struct BallPostings *pp)
+{
+	if (pp == NULL) return;
+
+	free(pp->bits);
+	free(pp);
 }
 
 
 
-UINT16 numberOfTerm(UINT16 sum)
+UINTROW getDrawRows(struct BallPostings *pp, UINT8 *balls, UINT8 count, MASKWORD *rowBits)
 {
-	UINT16 n;
-	SINT32 sum2 = (SINT32) sum;
+	MASKWORD *bits, x;
+	UINTROW rows = 0;
+	UINT32 w;
+	UINT8 i;
 
-	for (n=0; sum2>0; n++) 
+	for (w=0; w < pp->words; w++) {
+		rowBits[w] = (count > 0) ? ~(MASKWORD) 0 : 0;
+	}
+
+	for (i=0; i < count; i++) 
 	{
-		sum2 = sum2 - (n+1);
+		bits = pp->bits + (UINT32) (balls[i] <= pp->totalBall ? balls[i] : 0) * pp->words;
+
+		for (w=0; w < pp->words; w++) {
+			rowBits[w] &= bits[w];
+		}
 	}
 
-	return n;
+	for (w=0; w < pp->words; w++) 
+	{
+		x = rowBits[w];
+
+		#if defined(__GNUC__) && !defined(__MSDOS__)
+		rows += (UINTROW) __builtin_popcountll(x);
+		#else
+		while (x) {
+			x &= x - 1;
+			rows++;
+		}
+		#endif
+	}
+
+	return rows;
 }
 
 
 
-UINT8 gaussIndex(UINT8 ballCount)
+void getPairRows(struct BallPostings *pp, UINT8 *balls, UINT8 count, UINTROW first, MASKWORD *rowBits)
 {
-	UINT16 node=0, leftnode=0, level;
+	MASKWORD *bits1, *bits2;
+	UINT32 w, firstWord = first / MASK_BITS;
+	UINT8 i, j;
 
-	for (level=1; level<ballCount; level++)
+	for (w=0; w < pp->words; w++) {
+		rowBits[w] = 0;
+	}
+
+	for (i=0; i < count; i++) 
 	{
-		if (rand() % 100 < 49 + rand() % 2) {
-			node = node + level;
-		} else {
-			node = node + level + 1;
-		}
+		if (balls[i] > pp->totalBall) continue;
 
-		leftnode = leftnode + level;
+		bits1 = pp->bits + (UINT32) balls[i]*pp->words;
+
+		for (j=i+1; j < count; j++) 
+		{
+			if (balls[j] > pp->totalBall) continue;
+
+			bits2 = pp->bits + (UINT32) balls[j]*pp->words;
+
+			for (w=firstWord; w < pp->words; w++) {
+				rowBits[w] |= bits1[w] & bits2[w];
+			}
+		}
 	}
 
-	return node - (leftnode-1);
+	/* rows before the first row */
+
+	if (firstWord < pp->words) rowBits[firstWord] &= ~(((MASKWORD) 1 << (first % MASK_BITS)) - 1);
 }
 
 
 
-UINT8 search5CombXY(struct ListXY *prvDrawnsList, struct ListX *drawnBalls)
+UINTROW nextDrawRow(struct BallPostings *pp, MASKWORD *rowBits, UINTROW r)
 {
-	UINT16 i, listRows;
-	UINT8 balls[DRAW_BALL+1];
-	struct ListX *aPrvDrawn = NULL;
-	UINT8 found = 0;
-
-	if (prvDrawnsList == winningDrawnBallsList) listRows = winningBallRows;
-	else listRows = lengthY(prvDrawnsList);
+	UINT32 w;
+	MASKWORD x;
+	UINT8 bit;
 
-	getKeys(drawnBalls, balls, 0, 0);
+	if (r >= pp->rows) return pp->rows;
 
-	aPrvDrawn = prvDrawnsList->list;
+	w = r / MASK_BITS;
+	x = rowBits[w] & ~(((MASKWORD) 1 << (r % MASK_BITS)) - 1);
 
-	for (i=0; aPrvDrawn && i<listRows; i++) 
-	{
-		if (aPrvDrawn->balls[0] <= balls[0] && seqSearchX(aPrvDrawn, balls, 5) == 5) {
-			found=1;
-			break;
-		}
+	while (x == 0) {
+		if (++w >= pp->words) return pp->rows;
+		x = rowBits[w];
+	}
 
-		aPrvDrawn = aPrvDrawn->next;
+	#if defined(__GNUC__) && !defined(__MSDOS__)
+	bit = (UINT8) __builtin_ctzll(x);
+	#else
+	for (bit=0; !(x & 1); bit++) {
+		x >>= 1;
 	}
+	#endif
 
-	return found;
+	return (UINTROW) (w*MASK_BITS + bit);
 }
 
 
 
-UINT8 search5CombX(struct ListX *aPrvDrawn, struct ListX *drawnBalls)
+int compareCombCount(const void *p1, const void *p2)
 {
-	UINT8 balls[DRAW_BALL+1];
-	UINT8 found = 0;
+	struct CombCount *c1 = *(struct CombCount **) p1;
+	struct CombCount *c2 = *(struct CombCount **) p2;
+	UINT8 i;
 
-	getKeys(drawnBalls, balls, 0, 0);
+	if (c1->count != c2->count) return c1->count > c2->count ? -1 : 1;
+	if (c1->first != c2->first) return c1->first < c2->first ? -1 : 1;
+	if (c1->second != c2->second) return c1->second < c2->second ? -1 : 1;
 
-	if (aPrvDrawn->balls[0] <= balls[0] && seqSearchX(aPrvDrawn, balls, 5) == 5) found=1;
+	for (i=0; i<DRAW_BALL; i++) {
+		if (c1->balls[i] != c2->balls[i]) return c1->balls[i] < c2->balls[i] ? -1 : 1;
+	}
 
-	return found;
+	return 0;
 }
 
 
 
-UINT8 search4CombXY(struct ListXY *prvDrawnsList, struct ListX *drawnBalls, struct ListXY *foundComb)
+struct ListXY *getCombCountList(struct ListXY *pl, struct CombTable *pc, struct TableXY *pt)
 {
-	UINT16 i, listRows;
-	UINT8 b1[DRAW_BALL+1];
-	UINT8 b2[5];
-	struct ListX *aPrvDrawn = NULL;
-	struct ListX *fc = NULL;
-	UINT8 found = 0;
+	struct CombCount **found = NULL;
+	struct CombCount *cc;
+	struct ListX *lb = NULL;
+	UINT32 i, n;
+	UINTDAY dDiff;
+	UINT8 keys[DRAW_BALL+1];
+	UINT8 j;
 
-	if (prvDrawnsList == winningDrawnBallsList) listRows = winningBallRows;
-	else listRows = lengthY(prvDrawnsList);
+	for (i=0, n=0; i<pc->size; i++) {
+		if (pc->items[i].count > 1) n++;
+	}
 
-	getKeys(drawnBalls, b1, 0, drawnBalls->size);
+	if (n == 0) return pl;
 
-	if (foundComb != NULL) removeAllXY(foundComb);
+	if ((found = (struct CombCount **) malloc(sizeof(struct CombCount *)*n)) == NULL) return pl;
 
-	aPrvDrawn = prvDrawnsList->list;
+	for (i=0, n=0; i<pc->size; i++) {
+		if (pc->items[i].count > 1) found[n++] = &pc->items[i];
+	}
 
-	for (i=0; aPrvDrawn && i<listRows; i++)
+	/* 
+	 * Sorted in the order the pairwise search had found the combinations (by the latest and the second latest draw),
+	 * and then by how many times the numbers drawn together 
+	 */
+	qsort(found, n, sizeof(struct CombCount *), compareCombCount);
+
+	for (i=n; i>0; i--)
 	{
-		b2[0] = b1[0];
-		b2[1] = b1[1];
-		b2[2] = b1[2];
-		b2[3] = b1[3];
-		b2[4] = '\0';
+		cc = found[i-1];
 
-		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 4) == 4) 
-		{
-			found++; 
+		dDiff = pt->epochDay[cc->first] - pt->epochDay[cc->last];
 
-			if (foundComb == NULL) {
-				break;
-			} else {
-				fc = createListX(fc, 4, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
-				appendItems(fc, b2);
-				appendList(foundComb, fc);
-			}
+		for (j=0; j<pc->comb; j++) {
+			keys[j] = cc->balls[j];
 		}
+		keys[pc->comb] = '\0';
 
-		//b2[0] = b1[0];
-		//b2[1] = b1[1];
-		//b2[2] = b1[2];
-		b2[3] = b1[4];
-		//b2[4] = '\0';
+		lb = createListX(lb, pc->comb, NULL, cc->count, (UINTDAY) (dDiff / (cc->count-1)), pt->year[cc->first], pt->mon[cc->first], pt->day[cc->first]);
+		appendItems(lb, keys);
+		insertList(pl, lb);
+	}
 
-		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 4) == 4) 
-		{
-			found++; 
+	free(found);
 
-			if (foundComb == NULL) {
-				break;
-			} else {
-				fc = createListX(fc, 4, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
-				appendItems(fc, b2);
-				appendList(foundComb, fc);
-			}
-		}
+	return pl;
+}
 
 
-		//b2[0] = b1[0];
-		//b2[1] = b1[1];
-		b2[2] = b1[3];
-		//b2[3] = b1[4];
-		//b2[4] = '\0';
 
-		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 4) == 4) 
-		{
-			found++; 
+void removeAllC(struct CombTable *pc)
+{
+	if (pc == NULL) return;
 
-			if (foundComb == NULL) {
-				break;
-			} else {
-				fc = createListX(fc, 4, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
-				appendItems(fc, b2);
-				appendList(foundComb, fc);
-			}
-		}
+	free(pc->items);
 
+	pc->items = NULL;
+	pc->size = 0;
+	pc->used = 0;
+}
 
-		//b2[0] = b1[0];
-		b2[1] = b1[2];
-		//b2[2] = b1[3];
-		//b2[3] = b1[4];
-		//b2[4] = '\0';
 
-		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 4) == 4) 
-		{
-			found++; 
 
-			if (foundComb == NULL) {
-				break;
-			} else {
-				fc = createListX(fc, 4, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
-				appendItems(fc, b2);
-				appendList(foundComb, fc);
-			}
-		}
 
+void insertItem2(struct ListX2 *pl, UINT8 key)
+{
+	if (pl->index < pl->size) 
+	{
+		memmove(pl->balls+1, pl->balls, pl->index);
 
-		b2[0] = b1[1];
-		//b2[1] = b1[2];
-		//b2[2] = b1[3];
-		//b2[3] = b1[4];
-		//b2[4] = '\0';
+		pl->balls[0] = key;
+		pl->index++;
+	}
+}
 
-		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 4) == 4) 
-		{
-			found++; 
 
-			if (foundComb == NULL) {
-				break;
-			} else {
-				fc = createListX(fc, 4, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
-				appendItems(fc, b2);
-				appendList(foundComb, fc);
-			}
-		}
 
-		aPrvDrawn = aPrvDrawn->next;
+struct ListX *atEndY(struct ListXY *pl)
+{
+	struct ListX *curr;
+
+	if (pl == NULL)
+		return NULL;
+
+	curr = pl->list;
+
+	while (curr->next) {
+		curr = curr->next;
 	}
 
-	return found;
+	return curr;
 }
 
 
 
-UINT8 search4CombX(struct ListX *aPrvDrawn, struct ListX *drawnBalls, struct ListXY *luckyBalls, char *buf)
+void appendItem(struct ListX *pl, UINT8 key)
 {
-	UINT8 b1[DRAW_BALL+1];
-	UINT8 b2[5];
-	UINT8 found = 0;
-
-	getKeys(drawnBalls, b1, 0, drawnBalls->size);
+	if (pl->index < pl->size) {
+		pl->balls[pl->index] = key;
+		pl->index++;
+	}
+}
 
-	if (buf) buf[0] = '\0';
 
-	b2[0] = b1[0];
-	b2[1] = b1[1];
-	b2[2] = b1[2];
-	b2[3] = b1[3];
-	b2[4] = '\0';
 
-	if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 4) == 4)
-	{
-		if (buf || luckyBalls) foundComb(aPrvDrawn, drawnBalls, luckyBalls, buf, b2, 4, found);
-		found++;
+void appendItem2(struct ListX2 *pl, UINT8 key, UINTROW val)
+{
+	if (pl->index < pl->size) {
+		pl->balls[pl->index] = key;
+		pl->vals[pl->index] = val;
+		pl->index++;
 	}
+}
 
-	//b2[0] = b1[0];
-	//b2[1] = b1[1];
-	//b2[2] = b1[2];
-	b2[3] = b1[4];
-	//b2[4] = '\0';
 
-	if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 4) == 4)
-	{
-		if (buf || luckyBalls) foundComb(aPrvDrawn, drawnBalls, luckyBalls, buf, b2, 4, found);
-		found++;
-	}
 
-	//b2[0] = b1[0];
-	//b2[1] = b1[1];
-	b2[2] = b1[3];
-	//b2[3] = b1[4];
-	//b2[4] = '\0';
-		
-	if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 4) == 4)
+void appendItems(struct ListX *pl, UINT8 *keys)
+{
+	UINT8 i, size = strlen((char *)keys);
+	
+	if (pl->index + size <= pl->size) 
 	{
-		if (buf || luckyBalls) foundComb(aPrvDrawn, drawnBalls, luckyBalls, buf, b2, 4, found);
-		found++;
-	}
+		for (i=0; i< size && keys[i] != '\0'; i++) {
+			pl->balls[pl->index+i] = keys[i];
+		}
 
-	//b2[0] = b1[0];
-	b2[1] = b1[2];
-	//b2[2] = b1[3];
-	//b2[3] = b1[4];
-	//b2[4] = '\0';
-		
-	if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 4) == 4)
-	{
-		if (buf || luckyBalls) foundComb(aPrvDrawn, drawnBalls, luckyBalls, buf, b2, 4, found);
-		found++;
+		pl->index += size;
 	}
+}
 
-	b2[0] = b1[1];
-	//b2[1] = b1[2];
-	//b2[2] = b1[3];
-	//b2[3] = b1[4];
-	//b2[4] = '\0';
 
-	if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 4) == 4)
-	{
-		if (buf || luckyBalls) foundComb(aPrvDrawn, drawnBalls, luckyBalls, buf, b2, 4, found);
-		found++;
-	}
 
-	return found;
+void insertList(struct ListXY *pl, struct ListX *newList)
+{
+	newList->next = pl->list;
+	pl->list = newList;
 }
 
 
 
-UINT8 search3CombXY(struct ListXY *prvDrawnsList, struct ListX *drawnBalls, struct ListXY *foundComb)
+void appendList(struct ListXY *pl, struct ListX *plNext)
 {
-	UINT16 i, listRows;
-	UINT8 b1[DRAW_BALL+1];
-	UINT8 b2[4];
-	struct ListX *aPrvDrawn = NULL;
-	struct ListX *fc = NULL;
-	UINT8 found = 0;
+	UINT8 i;
 
-	if (prvDrawnsList == winningDrawnBallsList) listRows = winningBallRows;
-	else listRows = lengthY(prvDrawnsList);
+	if (pl == NULL) return;
 
-	getKeys(drawnBalls, b1, 0, drawnBalls->size);
+	if (pl->list == NULL) {
+		pl->list = plNext;
+	} else {
+		(atEndY(pl))->next = plNext;
+		plNext->next = NULL;
+	}
 
-	if (foundComb != NULL) removeAllXY(foundComb);
+	if (pl->couponIndex) {
+		pl->couponIndex->rows++;
+		for (i=1; i<=pl->couponIndex->maxComb; i++) {
+			probeCouponIndex(pl->couponIndex, plNext, i, 1);
+		}
+	}
+}
 
-	aPrvDrawn = prvDrawnsList->list;
 
-	for (i=0; aPrvDrawn && i<listRows; i++)
-	{
-		b2[0] = b1[0];
-		b2[1] = b1[1];
-		b2[2] = b1[2];
-		b2[3] = '\0';
 
-		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 3) == 3) 
-		{
-			found++; 
+UINT8 removeItemByIndex2(struct ListX2 *pl, UINT8 ind)
+{
+	UINT8 key = pl->balls[ind];
 
-			if (foundComb == NULL) {
-				break;
-			} else {
-				fc = createListX(fc, 3, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
-				appendItems(fc, b2);
-				appendList(foundComb, fc);
-			}
-		}
+	memmove(pl->balls+ind, pl->balls+ind+1, pl->index-ind-1);
 
-		//b2[0] = b1[0];
-		//b2[1] = b1[1];
-		b2[2] = b1[3];
-		//b2[3] = '\0';
+	pl->index--;
+	pl->balls[pl->index] = '\0';
 
-		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 3) == 3) 
-		{
-			found++; 
+	return key;
+}
 
-			if (foundComb == NULL) {
-				break;
-			} else {
-				fc = createListX(fc, 3, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
-				appendItems(fc, b2);
-				appendList(foundComb, fc);
-			}
-		}
 
-		//b2[0] = b1[0];
-		//b2[1] = b1[1];
-		b2[2] = b1[4];
-		//b2[3] = '\0';
 
-		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 3) == 3) 
-		{
-			found++; 
+struct ListX * removeListByIndex(struct ListXY *pl, UINTROW ind)
+{
+	struct ListX *prv, *pt = pl->list;
+	UINTROW i;
+	struct ListX *list;
 
-			if (foundComb == NULL) {
-				break;
-			} else {
-				fc = createListX(fc, 3, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
-				appendItems(fc, b2);
-				appendList(foundComb, fc);
+	if (pt) 
+	{
+		if (ind == 0) {
+			list = pt;
+			pl->list = pt->next;
+		} else {
+			for (i=1, prv=pt, pt=pt->next; (pt) && (i<ind); prv=prv->next, pt=pt->next, i++);
+
+			if (i == ind) {
+				list = pt;
+				prv->next = pt->next;
 			}
 		}
+	}
 
+	return list;
+}
 
-		//b2[0] = b1[0];
-		b2[1] = b1[2];
-		b2[2] = b1[3];
-		//b2[3] = '\0';
-
-		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 3) == 3) 
-		{
-			found++; 
 
-			if (foundComb == NULL) {
-				break;
-			} else {
-				fc = createListX(fc, 3, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
-				appendItems(fc, b2);
-				appendList(foundComb, fc);
-			}
-		}
 
-		//b2[0] = b1[0];
-		//b2[1] = b1[2];
-		b2[2] = b1[4];
-		//b2[3] = '\0';
+struct ListXY * shuffleListXY(struct ListXY *pl)
+{
+	UINT16 i, index;
+	struct ListX *list;
+	UINT16 listLen = lengthY(pl);
+	UINT16 shuffleList = (UINT16) ((listLen * (randomBelow(&rng, 6) + (UINT16) ceil(listLen/2) - 5) * (randomBelow(&rng, 6) + (UINT16) ceil(listLen/3) - 5)));
 
-		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 3) == 3) 
-		{
-			found++; 
+	for (i=0; i<shuffleList; i++)
+	{
+		index = randomBelow(&rng, listLen);
+		list = removeListByIndex(pl, index);
 
-			if (foundComb == NULL) {
-				break;
-			} else {
-				fc = createListX(fc, 3, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
-				appendItems(fc, b2);
-				appendList(foundComb, fc);
-			}
+		if (index < (UINT16) ceil(listLen/3)) {
+			insertList(pl, list);
+		}
+		else if (index < (UINT16) ceil(listLen/2)) {
+			addListByIndex(pl, list, (UINT16) ceil(2*listLen/3));
+		}
+		else if (index < (UINT16) ceil(2*listLen/3)) {
+			addListByIndex(pl, list, (UINT16) ceil(listLen/3));
+		}
+		else {
+			appendList(pl, list);
 		}
+	}
 
+	return pl;
+}
 
-		//b2[0] = b1[0];
-		b2[1] = b1[3];
-		//b2[2] = b1[4];
-		//b2[3] = '\0';
 
-		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 3) == 3) 
-		{
-			found++; 
 
-			if (foundComb == NULL) {
-				break;
-			} else {
-				fc = createListX(fc, 3, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
-				appendItems(fc, b2);
-				appendList(foundComb, fc);
-			}
-		}
+UINT8 addItemByIndex2(struct ListX2 *pl, UINT8 ind, UINT8 key)
+{
+	if (pl->index < pl->size) 
+	{
+		if (ind > pl->index) ind = pl->index;
 
+		memmove(pl->balls+ind+1, pl->balls+ind, pl->index-ind);
 
-		b2[0] = b1[1];
-		b2[1] = b1[2];
-		b2[2] = b1[3];
-		//b2[3] = '\0';
+		pl->balls[ind] = key;
+		pl->index++;
+	} 
+	else {
+		return 0;
+	}
 
-		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 3) == 3) 
-		{
-			found++; 
+	return 1;
+}
 
-			if (foundComb == NULL) {
-				break;
-			} else {
-				fc = createListX(fc, 3, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
-				appendItems(fc, b2);
-				appendList(foundComb, fc);
-			}
-		}
 
-		//b2[0] = b1[1];
-		//b2[1] = b1[2];
-		b2[2] = b1[4];
-		//b2[3] = '\0';
 
-		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 3) == 3) 
-		{
-			found++; 
+void addListByIndex(struct ListXY *pl, struct ListX *newList, UINTROW ind)
+{
+	UINTROW i;
+	struct ListX *right = NULL, *left = pl->list;
 
-			if (foundComb == NULL) {
-				break;
-			} else {
-				fc = createListX(fc, 3, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
-				appendItems(fc, b2);
-				appendList(foundComb, fc);
-			}
+	if (left == NULL || ind == 0) 
+	{
+		pl->list = newList;
+		newList->next = left;
+	} 
+	else 
+	{
+		right = left->next;
+
+		for (i=1; i<ind; i++) {
+			if (left != NULL) left = left->next;
+			if (right != NULL) right = right->next;
 		}
 
+		if (left == NULL) return;
 
-		//b2[0] = b1[1];
-		b2[1] = b1[3];
-		//b2[2] = b1[4];
-		//b2[3] = '\0';
+		left->next = newList;
+		newList->next = right;
+	}
+}
 
-		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 3) == 3) 
-		{
-			found++; 
 
-			if (foundComb == NULL) {
-				break;
-			} else {
-				fc = createListX(fc, 3, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
-				appendItems(fc, b2);
-				appendList(foundComb, fc);
-			}
-		}
 
+void removeAllX(struct ListX *pl)
+{
+	UINT8 i;
 
-		b2[0] = b1[2];
-		//b2[1] = b1[3];
-		//b2[2] = b1[4];
-		//b2[3] = '\0';
+	for (i=0; i<pl->size; i++) {
+		pl->balls[i] = '\0';
+	}
+    
+	pl->index = 0;
+}
 
-		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 3) == 3) 
-		{
-			found++; 
 
-			if (foundComb == NULL) {
-				break;
-			} else {
-				fc = createListX(fc, 3, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
-				appendItems(fc, b2);
-				appendList(foundComb, fc);
-			}
-		}
 
-		aPrvDrawn = aPrvDrawn->next;
-	}
+void removeAllX2(struct ListX2 *pl)
+{
+	UINT8 i;
 
-	return found;
+	for (i=0; i<pl->size; i++) {
+		pl->balls[i] = '\0';
+		pl->vals[i] = '\0';
+	}
+    
+	pl->index = 0;
 }
 
 
 
-UINT8 search3CombX(struct ListX *aPrvDrawn, struct ListX *drawnBalls, struct ListXY *luckyBalls, char *buf)
+void removeAllXY(struct ListXY *pl)
 {
-	UINT8 b1[DRAW_BALL+1];
-	UINT8 b2[4];
-	UINT8 found = 0;
+	struct ListX *prvList, *pList = pl->list;
 
-	getKeys(drawnBalls, b1, 0, drawnBalls->size);
+	while (pList != NULL) 
+	{
+		prvList = pList;
+		pList = pList->next;
+		//removeAllX(prvList);
+		free(prvList->balls);
+		if (prvList->label) free(prvList->label);
+		free(prvList);
+	} 
 
-	if (buf) buf[0] = '\0';
+	pl->list = NULL;
+}
 
-	b2[0] = b1[0];
-	b2[1] = b1[1];
-	b2[2] = b1[2];
-	b2[3] = '\0';
-		
-	if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 3) == 3)
-	{
-		if (buf || luckyBalls) foundComb(aPrvDrawn, drawnBalls, luckyBalls, buf, b2, 3, found);
-		found++;
-	}
 
-	//b2[0] = b1[0];
-	//b2[1] = b1[1];
-	b2[2] = b1[3];
-	//b2[3] = '\0';
-		
-	if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 3) == 3)
-	{
-		if (buf || luckyBalls) foundComb(aPrvDrawn, drawnBalls, luckyBalls, buf, b2, 3, found);
-		found++;
-	}
 
-	//b2[0] = b1[0];
-	//b2[1] = b1[1];
-	b2[2] = b1[4];
-	//b2[3] = '\0';
+UINTROW lengthY(struct ListXY *pl)
+{
+	struct ListX *tmp = pl->list;
+	UINTROW i=0;
 
-	if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 3) == 3)
+	while (tmp)
 	{
-		if (buf || luckyBalls) foundComb(aPrvDrawn, drawnBalls, luckyBalls, buf, b2, 3, found);
-		found++;
+		i++;
+		tmp = tmp->next;
 	}
 
-	//b2[0] = b1[0];
-	b2[1] = b1[2];
-	b2[2] = b1[3];
-	//b2[3] = '\0';
-		
-	if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 3) == 3)
-	{
-		if (buf || luckyBalls) foundComb(aPrvDrawn, drawnBalls, luckyBalls, buf, b2, 3, found);
-		found++;
-	}
+	return i;
+}
 
-	//b2[0] = b1[0];
-	//b2[1] = b1[2];
-	b2[2] = b1[4];
-	//b2[3] = '\0';
 
-	if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 3) == 3)
-	{
-		if (buf || luckyBalls) foundComb(aPrvDrawn, drawnBalls, luckyBalls, buf, b2, 3, found);
-		found++;
-	}
 
-	//b2[0] = b1[0];
-	b2[1] = b1[3];
-	//b2[2] = b1[4];
-	//b2[3] = '\0';
-		
-	if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 3) == 3)
+UINT8 seqSearchX(struct ListX *pl, UINT8 *keys, UINT8 size)
+{
+	UINT8 found=0;
+	UINT8 i, j;
+
+	for (i=0; i < pl->index -(size-1); i++) 
 	{
-		if (buf || luckyBalls) foundComb(aPrvDrawn, drawnBalls, luckyBalls, buf, b2, 3, found);
-		found++;
+		for (j=0; j < size; j++) {
+			if (pl->balls[i+j] == keys[j]) found++;
+		}
+
+		if (found == size) break;
 	}
 
-	b2[0] = b1[1];
-	b2[1] = b1[2];
-	b2[2] = b1[3];
-	//b2[3] = '\0';
+	return found;
+}
+
 
-	if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 3) == 3)
-	{
-		if (buf || luckyBalls) foundComb(aPrvDrawn, drawnBalls, luckyBalls, buf, b2, 3, found);
-		found++;
-	}
 
-	//b2[0] = b1[1];
-	//b2[1] = b1[2];
-	b2[2] = b1[4];
-	//b2[3] = '\0';
-		
-	if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 3) == 3)
+int seqSearchX1(struct ListX *pl, UINT8 key)
+{
+	UINT8 i;
+
+	for (i=0; i<pl->index; i++) 
 	{
-		if (buf || luckyBalls) foundComb(aPrvDrawn, drawnBalls, luckyBalls, buf, b2, 3, found);
-		found++;
+		if (pl->balls[i] == key) return i;
 	}
 
-	//b2[0] = b1[1];
-	b2[1] = b1[3];
-	//b2[2] = b1[4];
-	//b2[3] = '\0';
+	return -1;
+}
+
 
-	if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 3) == 3)
+
+int seqSearchX2(struct ListX2 *pl, UINT8 key)
+{
+	UINT8 i;
+
+	for (i=0; i<pl->index; i++) 
 	{
-		if (buf || luckyBalls) foundComb(aPrvDrawn, drawnBalls, luckyBalls, buf, b2, 3, found);
-		found++;
+		if (pl->balls[i] == key) return i;
 	}
 
-	b2[0] = b1[2];
-	//b2[1] = b1[3];
-	//b2[2] = b1[4];
-	//b2[3] = '\0';
-		
-	if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 3) == 3)
+	return -1;
+}
+
+
+
+int seqSearchXY(struct ListXY *pl, UINT8 *keys, UINT8 size)
+{
+	struct ListX *tmp = pl->list;
+	UINTROW i=0;
+
+	while (tmp)
 	{
-		if (buf || luckyBalls) foundComb(aPrvDrawn, drawnBalls, luckyBalls, buf, b2, 3, found);
-		found++;
+		if (seqSearchX(tmp, keys, size) == size) break;
+		tmp = tmp->next;
+		i++;
 	}
 
-	return found;
+	if (tmp) return i;
+	else return -1;
 }
 
 
 
-UINT8 search2CombXY(struct ListXY *prvDrawnsList, struct ListX *drawnBalls, struct ListXY *foundComb)
+void incVal2(struct ListX2 *pl, UINT8 ind)
 {
-	UINT16 i, listRows;
-	UINT8 b1[DRAW_BALL+1];
-	UINT8 b2[3];
-	struct ListX *aPrvDrawn = NULL;
-	struct ListX *fc = NULL;
-	UINT8 found = 0;
-
-	if (prvDrawnsList == winningDrawnBallsList) listRows = winningBallRows;
-	else listRows = lengthY(prvDrawnsList);
+    pl->vals[ind]++;
+}
 
-	getKeys(drawnBalls, b1, 0, drawnBalls->size);
 
-	if (foundComb != NULL) removeAllXY(foundComb);
 
-	aPrvDrawn = prvDrawnsList->list;
+void incValXY(struct ListXY *pl, UINTROW ind)
+{
+	struct ListX *tmp = pl->list;
+	UINTROW i;
 
-	for (i=0; aPrvDrawn && i<listRows; i++) 
+	for (i=0; (tmp) && i<ind; i++) 
 	{
-		b2[0] = b1[0];
-		b2[1] = b1[1];
-		b2[2] = '\0';
+		tmp=tmp->next;
+	}
 
-		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 2) == 2) 
-		{
-			found++; 
+	tmp->val++;
+}
 
-			if (foundComb == NULL) {
-				break;
-			} else {
-				fc = createListX(fc, 2, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
-				appendItems(fc, b2);
-				appendList(foundComb, fc);
-			}
-		}
 
-		//b2[0] = b1[0];
-		b2[1] = b1[2];
-		//b2[2] = '\0';
 
-		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 2) == 2) 
-		{
-			found++; 
+UINTROW getValXY(struct ListXY *pl, UINTROW ind)
+{
+	struct ListX *tmp = pl->list;
+	UINTROW i;
 
-			if (foundComb == NULL) {
-				break;
-			} else {
-				fc = createListX(fc, 2, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
-				appendItems(fc, b2);
-				appendList(foundComb, fc);
-			}
-		}
+	for (i=0; (tmp) && i<ind; i++) 
+	{
+		tmp=tmp->next;
+	}
 
-		//b2[0] = b1[0];
-		b2[1] = b1[3];
-		//b2[2] = '\0';
+	return tmp->val;
+}
 
-		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 2) == 2) 
-		{
-			found++; 
 
-			if (foundComb == NULL) {
-				break;
-			} else {
-				fc = createListX(fc, 2, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
-				appendItems(fc, b2);
-				appendList(foundComb, fc);
-			}
-		}
 
-		//b2[0] = b1[0];
-		b2[1] = b1[4];
-		//b2[2] = '\0';
+UINT8 getKey(struct ListX *pl, UINT8 index)
+{
+	return pl->balls[index];
+}
 
-		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 2) == 2) 
-		{
-			found++; 
 
-			if (foundComb == NULL) {
-				break;
-			} else {
-				fc = createListX(fc, 2, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
-				appendItems(fc, b2);
-				appendList(foundComb, fc);
-			}
-		}
 
+UINT8 getKey2(struct ListX2 *pl, UINT8 index)
+{
+	return pl->balls[index];
+}
 
-		b2[0] = b1[1];
-		b2[1] = b1[2];
-		//b2[2] = '\0';
 
-		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 2) == 2) 
-		{
-			found++; 
 
-			if (foundComb == NULL) {
-				break;
-			} else {
-				fc = createListX(fc, 2, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
-				appendItems(fc, b2);
-				appendList(foundComb, fc);
-			}
-		}
+void getKeys(struct ListX *pl, UINT8 *keys, UINT8 index, UINT8 count)
+{
+	UINT8 i, j;
 
-		//b2[0] = b1[1];
-		b2[1] = b1[3];
-		//b2[2] = '\0';
+	if (count == 0) count = pl->index;
 
-		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 2) == 2) 
-		{
-			found++; 
+	for (i=index, j=0; j<count; i++, j++) 
+	{
+		keys[j] = pl->balls[i];
+	}
 
-			if (foundComb == NULL) {
-				break;
-			} else {
-				fc = createListX(fc, 2, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
-				appendItems(fc, b2);
-				appendList(foundComb, fc);
-			}
-		}
+	keys[j] = '\0';
+}
 
-		//b2[0] = b1[1];
-		b2[1] = b1[4];
-		//b2[2] = '\0';
 
-		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 2) == 2) 
-		{
-			found++; 
 
-			if (foundComb == NULL) {
-				break;
-			} else {
-				fc = createListX(fc, 2, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
-				appendItems(fc, b2);
-				appendList(foundComb, fc);
-			}
-		}
+struct ListX * getListXByIndex(struct ListXY *pl, UINTROW ind)
+{
+	struct ListX *l = pl->list;
+	UINTROW i;
 
+	for (i=0; (l) && i<ind; i++) 
+	{
+		l = l->next;
+	}
 
-		b2[0] = b1[2];
-		b2[1] = b1[3];
-		//b2[2] = '\0';
+	return l;
+}
 
-		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 2) == 2) 
-		{
-			found++; 
 
-			if (foundComb == NULL) {
-				break;
-			} else {
-				fc = createListX(fc, 2, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
-				appendItems(fc, b2);
-				appendList(foundComb, fc);
-			}
-		}
 
-		//b2[0] = b1[2];
-		b2[1] = b1[4];
-		//b2[2] = '\0';
+void bubbleSortX2ByVal(struct ListX2 *pl, int inc)
+{
+	UINT8 i;
+	UINT8 tmp, swapped;
+	UINTROW tmp2;
 
-		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 2) == 2) 
+	if (pl->index < 2) return;
+
+	do {
+		swapped = 0;
+
+		for (i=0; i < pl->index -1; i++)
 		{
-			found++; 
+			if ((inc == 1 && pl->vals[i] > pl->vals[i+1]) || (inc == -1 && pl->vals[i] < pl->vals[i+1])) 
+			{
+				tmp = pl->balls[i];
+				pl->balls[i] = pl->balls[i+1];
+				pl->balls[i+1] = tmp;
 
-			if (foundComb == NULL) {
-				break;
-			} else {
-				fc = createListX(fc, 2, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
-				appendItems(fc, b2);
-				appendList(foundComb, fc);
+				tmp2 = pl->vals[i];
+				pl->vals[i] = pl->vals[i+1];
+				pl->vals[i+1] = tmp2;
+
+				swapped = 1;
 			}
 		}
+	} while (swapped);
+}
 
 
-		b2[0] = b1[3];
-		//b2[1] = b1[4];
-		//b2[2] = '\0';
 
-		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 2) == 2) 
-		{
-			found++; 
+void bubbleSortYByVal(struct ListXY *pl, int inc)
+{
+	UINT8 swapped;
+	struct ListX *ptr1;
+	struct ListX *lptr = NULL;
 
-			if (foundComb == NULL) {
-				break;
-			} else {
-				fc = createListX(fc, 2, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
-				appendItems(fc, b2);
-				appendList(foundComb, fc);
+	if (pl->list == NULL) return;
+
+	do {
+		swapped = 0;
+		ptr1 = pl->list;
+
+		while (ptr1->next != lptr)
+		{
+			if ((inc == 1 && ptr1->val > ptr1->next->val) || (inc == -1 && ptr1->val < ptr1->next->val)) {
+				swapY(ptr1, ptr1->next);
+				swapped = 1;
 			}
+			ptr1 = ptr1->next;
 		}
 
-		aPrvDrawn = aPrvDrawn->next;
-	}
+		lptr = ptr1;
 
-	return found;
+	} while (swapped);
 }
 
 
 
-UINT8 search2CombX(struct ListX *aPrvDrawn, struct ListX *drawnBalls, struct ListXY *luckyBalls, char *buf)
+void bubbleSortYByVal2(struct ListXY *pl, int inc)
 {
-	UINT8 b1[DRAW_BALL+1];
-	UINT8 b2[3];
-	UINT8 found = 0;
+	UINT8 swapped;
+	struct ListX *ptr1;
+	struct ListX *lptr = NULL;
 
-	getKeys(drawnBalls, b1, 0, drawnBalls->size);
+	if (pl->list == NULL) return;
 
-	if (buf) buf[0] = '\0';
+	do {
+		swapped = 0;
+		ptr1 = pl->list;
 
-	b2[0] = b1[0];
-	b2[1] = b1[1];
-	b2[2] = '\0';
-		
-	if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 2) == 2)
-	{
-		if (buf || luckyBalls) foundComb(aPrvDrawn, drawnBalls, luckyBalls, buf, b2, 2, found);
-		found++;
-	}
+		while (ptr1->next != lptr)
+		{
+			if ((inc == 1 && ptr1->val2 > ptr1->next->val2) || (inc == -1 && ptr1->val2 < ptr1->next->val2)) {
+				swapY(ptr1, ptr1->next);
+				swapped = 1;
+			}
+			ptr1 = ptr1->next;
+		}
 
-	//b2[0] = b1[0];
-	b2[1] = b1[2];
-	//b2[2] = '\0';
-		
-	if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 2) == 2)
-	{
-		if (buf || luckyBalls) foundComb(aPrvDrawn, drawnBalls, luckyBalls, buf, b2, 2, found);
-		found++;
-	}
+		lptr = ptr1;
 
-	//b2[0] = b1[0];
-	b2[1] = b1[3];
-	//b2[2] = '\0';
-		
-	if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 2) == 2)
-	{
-		if (buf || luckyBalls) foundComb(aPrvDrawn, drawnBalls, luckyBalls, buf, b2, 2, found);
-		found++;
-	}
+	} while (swapped);
+}
 
-	//b2[0] = b1[0];
-	b2[1] = b1[4];
-	//b2[2] = '\0';
 
-	if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 2) == 2)
-	{
-		if (buf || luckyBalls) foundComb(aPrvDrawn, drawnBalls, luckyBalls, buf, b2, 2, found);
-		found++;
-	}
 
-	b2[0] = b1[1];
-	b2[1] = b1[2];
-	//b2[2] = '\0';
-		
-	if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 2) == 2)
-	{
-		if (buf || luckyBalls) foundComb(aPrvDrawn, drawnBalls, luckyBalls, buf, b2, 2, found);
-		found++;
-	}
+void bubbleSortXByKey(struct ListX *pl)
+{
+	UINT8 i;
+	UINT8 tmp, swapped;
 
-	//b2[0] = b1[1];
-	b2[1] = b1[3];
-	//b2[2] = '\0';
-		
-	if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 2) == 2)
-	{
-		if (buf || luckyBalls) foundComb(aPrvDrawn, drawnBalls, luckyBalls, buf, b2, 2, found);
-		found++;
-	}
+	if (pl->index < 2) return;
 
-	//b2[0] = b1[1];
-	b2[1] = b1[4];
-	//b2[2] = '\0';
-		
-	if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 2) == 2)
-	{
-		if (buf || luckyBalls) foundComb(aPrvDrawn, drawnBalls, luckyBalls, buf, b2, 2, found);
-		found++;
-	}
+	do {
+		swapped = 0;
 
-	b2[0] = b1[2];
-	b2[1] = b1[3];
-	//b2[2] = '\0';
-
-	if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 2) == 2)
-	{
-		if (buf || luckyBalls) foundComb(aPrvDrawn, drawnBalls, luckyBalls, buf, b2, 2, found);
-		found++;
-	}
-
-	//b2[0] = b1[2];
-	b2[1] = b1[4];
-	//b2[2] = '\0';
-		
-	if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 2) == 2)
-	{
-		if (buf || luckyBalls) foundComb(aPrvDrawn, drawnBalls, luckyBalls, buf, b2, 2, found);
-		found++;
-	}
-
-	b2[0] = b1[3];
-	//b2[1] = b1[4];
-	//b2[2] = '\0';
-		
-	if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 2) == 2)
-	{
-		if (buf || luckyBalls) foundComb(aPrvDrawn, drawnBalls, luckyBalls, buf, b2, 2, found);
-		found++;
-	}
-
-	return found;
+		for (i=0; i < pl->index -1; i++)
+		{
+			if (pl->balls[i] > pl->balls[i+1]) {
+				tmp = pl->balls[i];
+				pl->balls[i] = pl->balls[i+1];
+				pl->balls[i+1] = tmp;
+				swapped = 1;
+			}
+		}
+	} while (swapped);
 }
 
 
 
-UINT8 search1BallXY(struct ListXY *couponList, struct ListX *drawnBalls, UINT8 drawBallCount)
+void swapY(struct ListX *a, struct ListX *b)
 {
-	UINT16 i;
-	UINT8 j;
-	struct ListX *aPrvDrawn = NULL;
-	UINT8 balls[DRAW_BALL+1];
-	UINT8 found = 0;
+	char *label;
+	UINT8 *balls;
+	UINT8 day, mon;
+	UINT32 epochDay;
+	UINT16 year;
+	UINTROW val;
+	UINTDAY val2;
 
-	getKeys(drawnBalls, balls, 0, drawBallCount);
+	balls = a->balls;
+	a->balls = b->balls;
+	b->balls = balls;
 
-	aPrvDrawn = couponList->list;
+	label = a->label;
+	a->label = b->label;
+	b->label = label;
 
-	for (i=0; aPrvDrawn && i<lengthY(couponList); i++) 
-	{
-		for (j=0; j<drawBallCount; j++) 
-		{
-			if (aPrvDrawn->balls[0] <= balls[j] && seqSearchX1(aPrvDrawn, balls[j]) >= 0) {
-				found=1; 
-				break;
-			}
-		}
+	day = a->day;
+	a->day = b->day;
+	b->day = day;
 
-		if (found) break;
+	mon = a->mon;
+	a->mon = b->mon;
+	b->mon = mon;
 
-		aPrvDrawn = aPrvDrawn->next;
-	}
+	year = a->year;
+	a->year = b->year;
+	b->year = year;
 
-	return found;
+	epochDay = a->epochDay;
+	a->epochDay = b->epochDay;
+	b->epochDay = epochDay;
+
+	val = a->val;
+	a->val = b->val;
+	b->val = val;
+
+	val2 = a->val2;
+	a->val2 = b->val2;
+	b->val2 = val2;
 }
 
 
 
-void foundComb(struct ListX *aPrvDrawn, struct ListX *drawnBalls, struct ListXY *luckyBalls, char *buf, UINT8 *balls, UINT8 comb, UINT8 foundPrev)
+void printListXByKey(struct ListX *pl, UINT8 printTo, FILE *fp)
 {
-	struct ListX *lb = NULL;
-	int index;
-	char fStr[14];
-	UINT16 dDiff;
+	UINT8 i;
+	char buf[5];
 
-	if (buf) 
+	for (i=0; i < pl->index; i++) 
 	{
-		if (foundPrev) strcat(buf, ", ");
-
-		switch (comb)
-		{
-		case 2 : sprintf(fStr, "(%2d,%2d)", balls[0], balls[1]);
-		break;
-		case 3 : sprintf(fStr, "(%2d,%2d,%2d)", balls[0], balls[1], balls[2]);
-		break;
-		case 4 : sprintf(fStr, "(%2d,%2d,%2d,%2d)", balls[0], balls[1], balls[2], balls[3]);
-		break;
-		default: break;
+		sprintf(buf, "%2d ", pl->balls[i]);
+		// If printTo == 0 print to screen and output file, 1: print to screen only, 2: print to output file only
+		if (printTo == 0 || printTo == 1) {
+			printf("%s", buf);
 		}
-
-		strcat(buf, fStr);
-	}
-
-	if (luckyBalls) 
-	{
-		if ((index = seqSearchXY(luckyBalls, balls, comb)) < 0) {
-			dDiff = dateDiff(aPrvDrawn->day, aPrvDrawn->mon, aPrvDrawn->year, drawnBalls->day, drawnBalls->mon, drawnBalls->year);
-			lb = createListX(lb, comb, NULL, 1, dDiff, drawnBalls->year, drawnBalls->mon, drawnBalls->day);
-			appendItems(lb, balls);
-			appendList(luckyBalls, lb);
-		} else {
-			lb = getListXByIndex(luckyBalls, index);
-			dDiff = dateDiff(aPrvDrawn->day, aPrvDrawn->mon, aPrvDrawn->year, lb->day, lb->mon, lb->year);
-			lb->val2 = (UINT16) ceil(dDiff / numberOfTerm(lb->val));
-			lb->val++;
+		if ((printTo == 0 || printTo == 2) && fp != NULL) {
+			fputs(buf, fp);
 		}
 	}
 }
 
 
 
-UINT8 init()
+void printListXYWithPNByKey(struct ListXY *pl1, struct ListXY *pl2, FILE *fp)
 {
-	time_t rawtime;
-	struct tm *timeInfo;
+	struct ListX *nl1 = pl1->list;
+	struct ListX *nl2 = pl2->list;
+	char ioBuf[60];
+	char buf[30];
+	UINT8 i, j;
 
-	struct ListX *tmp = NULL;
-	struct ListX *tmp2 = NULL;
-	int err;
-	char realPath[PATH_MAX];
-	cwd = (char *) malloc(sizeof(char)*PATH_MAX);
-	fileStats = (char *) malloc(sizeof(char)*PATH_MAX);
-	outputFile = (char *) malloc(sizeof(char)*PATH_MAX);
+	puts("     Numbers       + Number\n");
+	if (fp != NULL) fputs("     Numbers       + Number\n\n", fp);
 
-	time(&rawtime);
-	timeInfo = localtime(&rawtime);
+	for (i=1; (nl1) && (nl2); i++)
+	{
+		ioBuf[0] = '\0';
 
-	fileStats[0] = '\0';
-	outputFile[0] = '\0';
+		sprintf(buf, "%2d - ", i);
+		strcat(ioBuf, buf);
 
-#if defined(__linux__) || defined(__unix__) || defined(__APPLE__) || defined(SOLARIS) || defined(WIN32)
-	err = get_app_path(realPath, PATH_MAX);
-	if (err) {
-		puts("App path lookup failed!");
-		return 0;
-	}
-	else {
-		cwd = dirname(realPath);
+		for (j=0; j < nl1->index; j++) {
+			sprintf(buf, "%2d ", nl1->balls[j]);
+			strcat(ioBuf, buf);
+		}
 
-		strcat(fileStats, cwd);
-		strcat(fileStats, PATH_SEPARATOR);
-		strcat(outputFile, cwd);
-		strcat(outputFile, PATH_SEPARATOR);
-	}
-#endif
+		strcat(ioBuf, "  ");
 
-	strcat(fileStats, FILESTATS);
-	strcat(outputFile, OUTPUTFILE);
+		for (j=0; j < nl2->index; j++) {
+			sprintf(buf, "%2d ", nl2->balls[j]);
+			strcat(ioBuf, buf);
+		}
 
-	puts("Initializing... Please wait.");
+		if (nl1->label) {
+			sprintf(buf, "     %s", nl1->label);
+			strcat(ioBuf, buf);
+		}
 
-	winningDrawnBallsList = createListXY(winningDrawnBallsList);
-	plusNumberDrawnBallsList = createListXY(plusNumberDrawnBallsList);
+		nl1 = nl1->next;
+		nl2 = nl2->next;
 
-	if (!(winningBallRows = getDrawnBallsList(winningDrawnBallsList, fileStats))) {
-		printf("%s file or record not found!\n", fileStats);
-		return 0;
-	}
+		strcat(ioBuf, "\n");
 
-	#ifndef __MSDOS__
-	if (!(pNumberBallRows = getDrawnBallsList(plusNumberDrawnBallsList, fileStats))) {
-		printf("%s file or record not found!\n", fileStats);
-		return 0;
+		printf("%s", ioBuf);
+		if (fp != NULL) fputs(ioBuf, fp);
 	}
-	#endif
+}
 
-	tmp = getListXByIndex(winningDrawnBallsList, winningBallRows-1);
-	formatDate(dateStart, tmp->day, tmp->mon, tmp->year);
-	tmp2 = winningDrawnBallsList->list;
-	formatDate(dateEnd, tmp2->day, tmp2->mon, tmp2->year);
 
-	drawnDays = dateDiff(tmp->day, tmp->mon, tmp->year, tmp2->day, tmp2->mon, tmp2->year);
 
-	currDay = (UINT8) timeInfo->tm_mday;
-	currMon = (UINT8) timeInfo->tm_mon +1;
-	currYear = (UINT16) timeInfo->tm_year +1900;
+void drawLargeCoupon(UINT32 rowCount, FILE *fp)
+{
+	struct ListXY *coupon = NULL;
+	struct ListXY *coupon_pn = NULL;
+	UINT32 row;
+	UINT8 n;
 
-	luckyBalls2 = createListXY(luckyBalls2);
-	luckyBalls2 = getLuckyBalls(luckyBalls2, 2);
-	bubbleSortYByVal(luckyBalls2, -1);
+	coupon = createListXY(coupon);
+	coupon_pn = createListXY(coupon_pn);
 
-	#if defined(__MSDOS__)
-	removeAllXY(winningDrawnBallsList);
-	if (!saveLuckyBallsToFile(luckyBalls2, 2)) return 0;
-	removeAllXY(luckyBalls2);
-	if (!(winningBallRows = getDrawnBallsList(winningDrawnBallsList, fileStats))) {
-		printf("%s file or record not found!\n", fileStats);
-		return 0;
-	}
-	#endif
+	coupon->couponIndex = createCouponIndex(coupon->couponIndex, TOTAL_BALL, DRAW_BALL);
+	coupon_pn->couponIndex = createCouponIndex(coupon_pn->couponIndex, TOTAL_BALL_PN, 1);
 
-	luckyBalls3 = createListXY(luckyBalls3);
-	luckyBalls3 = getLuckyBalls(luckyBalls3, 3);
-	bubbleSortYByVal(luckyBalls3, -1);
+	fputs("          Numbers       + Number\n\n", fp);
 
-	#if defined(__MSDOS__)
-	removeAllXY(winningDrawnBallsList);
-	if (!saveLuckyBallsToFile(luckyBalls3, 3)) return 0;
-	removeAllXY(luckyBalls3);
-	if (!(winningBallRows = getDrawnBallsList(winningDrawnBallsList, fileStats))) {
-		printf("%s file or record not found!\n", fileStats);
-		return 0;
-	}
-	#endif
+	for (row=0; row < rowCount; row += n)
+	{
+		n = (rowCount-row > LARGECHUNK) ? LARGECHUNK : (UINT8) (rowCount-row);
 
-	luckyBalls4 = createListXY(luckyBalls4);
-	luckyBalls4 = getLuckyBalls(luckyBalls4, 4);
-   	bubbleSortYByVal(luckyBalls4, -1);
+		showProgress = 0;
 
-	#if defined(__MSDOS__)
-	removeAllXY(winningDrawnBallsList);
-	if (!saveLuckyBallsToFile(luckyBalls4, 4)) return 0;
-	removeAllXY(luckyBalls4);
-	if (!(winningBallRows = getDrawnBallsList(winningDrawnBallsList, fileStats))) {
-		printf("%s file or record not found!\n", fileStats);
-		return 0;
-	}
-	if (!(pNumberBallRows = getDrawnBallsList(plusNumberDrawnBallsList, fileStats))) {
-		printf("%s file or record not found!\n", fileStats);
-		return 0;
-	}
-	#endif
+		/* coupon, totalBall, drawBallCount, drawRowCount, drawByNorm, left, blend1, blend2, side, rand, lucky */
+		drawBalls(coupon, TOTAL_BALL, DRAW_BALL, n, 1, 1, 1, 1, 1, 1, 1);
+		drawBalls(coupon_pn, TOTAL_BALL_PN, 1, n, 1, 1, 1, 1, 1, 1, 1);
 
-	winningBallsDrawCount = createListX2(winningBallsDrawCount, TOTAL_BALL);
-	plusNumberBallsDrawCount = createListX2(plusNumberBallsDrawCount, TOTAL_BALL_PN);
-	getDrawnBallCount();
+		showProgress = 1;
 
-	removeAllXY(plusNumberDrawnBallsList);
+		printCouponRows(coupon, coupon_pn, row, fp);
+		fflush(fp);
 
-	calcMatchCombCount();
-	clearScreen();
+		removeAllXY(coupon_pn);
+		removeAllXY(coupon);
 
-	#ifdef __MSDOS__
-	free(cwd);
-	free(fileStats);
-	cwd = NULL;
-	fileStats = NULL;
-	#endif
+		if (fp != stdout) printPercentOfProgress("Rows", row+n, rowCount);
+	}
 
-	return 1;
+	fprintf(fp, "\nSeed: %lu (%lu rows%s)\n", (unsigned long) randomSeed, (unsigned long) rowCount, drawThreads ? ", --threads" : "");
+
+	if (fp != stdout) printf("\n");
+
+	removeCouponIndex(coupon_pn->couponIndex);
+	removeCouponIndex(coupon->couponIndex);
+	free(coupon_pn);
+	free(coupon);
 }
 
 
 
-struct ListXY * getLuckyBalls(struct ListXY *luckyBalls, UINT8 comb)
+void printCouponRows(struct ListXY *pl1, struct ListXY *pl2, UINT32 firstRow, FILE *fp)
 {
-	UINT16 i, j;
-	struct ListX *aPrvDrawn1 = NULL;
-	struct ListX *aPrvDrawn2 = NULL;
-	struct ListX *list = NULL;
-
-	aPrvDrawn1 = winningDrawnBallsList->list;
+	struct ListX *nl1 = pl1->list;
+	struct ListX *nl2 = pl2->list;
+	char ioBuf[70];
+	char buf[30];
+	UINT32 i;
+	UINT8 j;
 
-	for (i=0; aPrvDrawn1 && i<winningBallRows; i++) 
+	for (i=firstRow+1; (nl1) && (nl2); i++)
 	{
-		aPrvDrawn2 = aPrvDrawn1->next;
+		ioBuf[0] = '\0';
 
-		for (j=i+1; aPrvDrawn2 && j<winningBallRows; j++) 
-		{
-			switch (comb)
-			{
-			case 2 : search2CombX(aPrvDrawn2, aPrvDrawn1, luckyBalls, NULL); break;
-			case 3 : search3CombX(aPrvDrawn2, aPrvDrawn1, luckyBalls, NULL); break;
-			case 4 : search4CombX(aPrvDrawn2, aPrvDrawn1, luckyBalls, NULL); break;
-			default: break;
-			}
-	
-			aPrvDrawn2 = aPrvDrawn2->next;
-		}
+		sprintf(buf, "%7lu - ", (unsigned long) i);
+		strcat(ioBuf, buf);
 
-		aPrvDrawn1 = aPrvDrawn1->next;
-	}
+		for (j=0; j < nl1->index; j++) {
+			sprintf(buf, "%2d ", nl1->balls[j]);
+			strcat(ioBuf, buf);
+		}
 
-	list = luckyBalls->list;
+		strcat(ioBuf, "  ");
 
-	while (list) {
-		list->val = numberOfTerm(list->val) +1;
-		list = list->next;
-	}
+		for (j=0; j < nl2->index; j++) {
+			sprintf(buf, "%2d ", nl2->balls[j]);
+			strcat(ioBuf, buf);
+		}
 
-	return luckyBalls;
+		if (nl1->label) {
+			sprintf(buf, "     %s", nl1->label);
+			strcat(ioBuf, buf);
+		}
+
+		nl1 = nl1->next;
+		nl2 = nl2->next;
+
+		strcat(ioBuf, "\n");
+
+		fputs(ioBuf, fp);
+	}
 }
 
 
 
-UINT8 saveLuckyBallsToFile(struct ListXY *luckyBalls, UINT8 comb)
+void searchTopTickets(UINT32 topCount, FILE *fp)
 {
-	struct ListX *nl = NULL;
-	char lbFile[14];
-	char ioBuf[20];
-	char buf[5];
-	UINT8 i;
-	FILE *fp;
+	struct TopSearch search;
+	struct TopTicket *tickets;
+	struct ListX *nl;
+	UINTROW *lastDrawn;
+	UINTROW r;
+	UINT32 i, n, count;
+	UINT16 t, threads = 1;
+	UINT8 j, b;
+	char ioBuf[70];
+	char buf[30];
+	#ifdef USE_THREADS
+	pthread_t *workers;
+	#endif
 
-	switch (comb)
+	n = TOTAL_BALL+1;
+
+	search.ballScore = (SINT32 *) calloc(n, sizeof(SINT32));
+	search.pairScore = (SINT32 *) calloc(n*n, sizeof(SINT32));
+	search.tripleScore = NULL;
+	search.topCount = topCount;
+	search.nextBall = 1;
+	search.nextHeap = 1;
+
+	lastDrawn = (UINTROW *) malloc(sizeof(UINTROW)*n);
+
+	#ifdef USE_THREADS
+	threads = drawThreads ? drawThreads : (UINT16) sysconf(_SC_NPROCESSORS_ONLN);
+	if (threads < 1) threads = 1;
+	if (threads > 64) threads = 64;
+	#endif
+
+	search.heaps = (struct TopHeap *) malloc(sizeof(struct TopHeap)*threads);
+
+	if (search.ballScore == NULL || search.pairScore == NULL || lastDrawn == NULL || search.heaps == NULL) {
+		puts("There is not enough memory for the ticket search!");
+		if (search.ballScore) free(search.ballScore);
+		if (search.pairScore) free(search.pairScore);
+		if (lastDrawn) free(lastDrawn);
+		if (search.heaps) free(search.heaps);
+		return;
+	}
+
+	/* draw counts of the balls minus the draws since the balls were last drawn (counted from the latest draw of the window) */
+
+	for (j=0; j < winningBallsDrawCount->index; j++) {
+		search.ballScore[winningBallsDrawCount->balls[j]] = (SINT32) winningBallsDrawCount->vals[j];
+	}
+
+	for (b=1; b <= TOTAL_BALL; b++) {
+		lastDrawn[b] = windowLast - windowFirst + 1;
+	}
+
+	for (r=windowLast+1; r > windowFirst; r--) {
+		for (j=0; j < winningDrawnBallsList->cols; j++) {
+			lastDrawn[winningDrawnBallsList->balls[(UINT32) (r-1)*winningDrawnBallsList->cols + j]] = r-1 - windowFirst;
+		}
+	}
+
+	for (b=1; b <= TOTAL_BALL; b++) {
+		search.ballScore[b] -= (SINT32) lastDrawn[b];
+	}
+
+	free(lastDrawn);
+
+	/* lucky pairs and triples (the balls of a lucky row are sorted) */
+
+	if (luckyBalls2) {
+		for (nl=luckyBalls2->list; nl; nl=nl->next) {
+			search.pairScore[(UINT32) nl->balls[0]*n + nl->balls[1]] = (SINT32) nl->val * TOPWEIGHT2;
+		}
+	}
+
+	if (luckyBalls3 && luckyBalls3->list && (search.tripleScore = (SINT32 *) calloc(n*n*n, sizeof(SINT32))) != NULL) {
+		for (nl=luckyBalls3->list; nl; nl=nl->next) {
+			search.tripleScore[((UINT32) nl->balls[0]*n + nl->balls[1])*n + nl->balls[2]] = (SINT32) nl->val * TOPWEIGHT3;
+		}
+	}
+
+	for (t=0; t < threads; t++)
 	{
-	case 2 : strcpy(lbFile, LBL2SWAPFILE); break;
-	case 3 : strcpy(lbFile, LBL3SWAPFILE); break;
-	case 4 : strcpy(lbFile, LBL4SWAPFILE); break;
-	default: break;
+		search.heaps[t].items = (struct TopTicket *) malloc(sizeof(struct TopTicket)*topCount);
+		search.heaps[t].count = 0;
+		search.heaps[t].size = search.heaps[t].items ? topCount : 0;
 	}
 
-	if ((fp = fopen(lbFile, "w")) == NULL) {
-		printf("Can't open file %s\n", lbFile);
-		pressAnyKeyToExit();
-		return 0;
+	if (fp != stdout) printf("%lu tickets are scored...\n", (unsigned long) combCount(TOTAL_BALL, DRAW_BALL));
+
+	#ifdef USE_THREADS
+	pthread_mutex_init(&search.lock, NULL);
+
+	workers = (pthread_t *) malloc(sizeof(pthread_t)*threads);
+
+	for (t=1; workers && t < threads; t++) {
+		if (pthread_create(&workers[t], NULL, topWorker, &search) != 0) break;
 	}
 
-	if (luckyBalls == NULL || luckyBalls->list == NULL) {
-		return 0;
+	/* the main thread is the first worker */
+	scoreTopTickets(&search, &search.heaps[0]);
+
+	while (workers && t > 1) pthread_join(workers[--t], NULL);
+
+	if (workers) free(workers);
+	pthread_mutex_destroy(&search.lock);
+	#else
+	scoreTopTickets(&search, &search.heaps[0]);
+	#endif
+
+	/* best tickets of the workers */
+
+	for (t=0, count=0; t < threads; t++) {
+		count += search.heaps[t].count;
 	}
 
-	nl = luckyBalls->list;
+	tickets = (struct TopTicket *) malloc(sizeof(struct TopTicket)*(count ? count : 1));
 
-	while (nl)
+	for (t=0, count=0; t < threads; t++) 
 	{
-		ioBuf[0] = '\0';
+		for (i=0; tickets && i < search.heaps[t].count; i++) {
+			tickets[count++] = search.heaps[t].items[i];
+		}
 
-		for (i=0; i < nl->index; i++) {
-			sprintf(buf, "%02d", nl->balls[i]);
+		if (search.heaps[t].items) free(search.heaps[t].items);
+	}
+
+	if (tickets)
+	{
+		qsort(tickets, count, sizeof(struct TopTicket), compareTopTickets);
+
+		if (count > topCount) count = topCount;
+
+		fprintf(fp, "Top %lu tickets by the draws between dates %s - %s\n\n", (unsigned long) count, dateStart, dateEnd);
+
+		for (i=0; i < count; i++)
+		{
+			ioBuf[0] = '\0';
+
+			sprintf(buf, "%7lu - ", (unsigned long) i+1);
+			strcat(ioBuf, buf);
+
+			for (j=0; j < DRAW_BALL; j++) {
+				sprintf(buf, "%2d ", tickets[i].balls[j]);
+				strcat(ioBuf, buf);
+			}
+
+			sprintf(buf, "    %ld\n", (long) tickets[i].score);
 			strcat(ioBuf, buf);
+
+			fputs(ioBuf, fp);
+		}
+
+		fprintf(fp, "\nScore: draw counts of the balls - draws since the balls were last drawn + %d x lucky pair counts + %d x lucky triple counts\n", TOPWEIGHT2, TOPWEIGHT3);
+
+		free(tickets);
+	}
+	else {
+		puts("There is not enough memory for the ticket search!");
+	}
+
+	free(search.heaps);
+	free(search.ballScore);
+	free(search.pairScore);
+	if (search.tripleScore) free(search.tripleScore);
+}
+
+
+
+void scoreTopTickets(struct TopSearch *ps, struct TopHeap *ph)
+{
+	UINT8 first;
+
+	if (ph->size == 0) return;
+
+	while (1)
+	{
+		#ifdef USE_THREADS
+		pthread_mutex_lock(&ps->lock);
+		#endif
+
+		first = ps->nextBall;
+		if (first <= TOTAL_BALL-DRAW_BALL+1) ps->nextBall++;
+
+		#ifdef USE_THREADS
+		pthread_mutex_unlock(&ps->lock);
+		#endif
+
+		if (first > TOTAL_BALL-DRAW_BALL+1) break;
+
+		scoreTopTicketsFrom(ps, ph, first);
+	}
+}
+
+
+
+void scoreTopTicketsFrom(struct TopSearch *ps, struct TopHeap *ph, UINT8 first)
+{
+	SINT32 score[DRAW_BALL][TOTAL_BALL+1];	// score[d][b]: score of ball b with the balls[0...d-1]
+	SINT32 sum[DRAW_BALL];					// sum[d]: score of the balls[0...d-1]
+	SINT32 *row, *prev, *pair, *triple, s;
+	UINT8 balls[DRAW_BALL];
+	UINT8 d, i, b, p;
+	UINT32 n = TOTAL_BALL+1;
+
+	for (b=1; b <= TOTAL_BALL; b++) {
+		score[0][b] = ps->ballScore[b];
+	}
+
+	sum[0] = 0;
+	balls[0] = first;
+	d = 0;
+
+	while (1)
+	{
+		/* score of the balls that can follow the balls[0...d] */
+
+		p = balls[d];
+		prev = score[d];
+		row = score[d+1];
+		pair = ps->pairScore + (UINT32) p*n;
+
+		sum[d+1] = sum[d] + prev[p];
+
+		for (b=p+1; b <= TOTAL_BALL; b++) {
+			row[b] = prev[b] + pair[b];
+		}
+
+		if (ps->tripleScore) 
+		{
+			for (i=0; i<d; i++) 
+			{
+				triple = ps->tripleScore + ((UINT32) balls[i]*n + p)*n;
+
+				for (b=p+1; b <= TOTAL_BALL; b++) {
+					row[b] += triple[b];
+				}
+			}
+		}
+
+		if (d+1 < DRAW_BALL-1) {
+			d++;
+			balls[d] = p+1;
+			continue;
+		}
+
+		/* last ball */
+
+		for (b=p+1; b <= TOTAL_BALL; b++) 
+		{
+			s = sum[d+1] + row[b];
+
+			if (ph->count == ph->size && s < ph->items[0].score) continue;
+
+			balls[d+1] = b;
+			addTopTicket(ph, s, balls);
+		}
+
+		/* next balls (the first ball is not changed) */
+
+		while (d > 0) {
+			balls[d]++;
+			if (balls[d] <= TOTAL_BALL-(DRAW_BALL-1-d)) break;
+			d--;
+		}
+
+		if (d == 0) break;
+	}
+}
+
+
+
+void addTopTicket(struct TopHeap *ph, SINT32 score, UINT8 *balls)
+{
+	struct TopTicket ticket, tmp;
+	UINT32 i, c;
+	UINT8 j;
+
+	ticket.score = score;
+	ticket.rank = combRank(balls, DRAW_BALL);
+
+	for (j=0; j < DRAW_BALL; j++) {
+		ticket.balls[j] = balls[j];
+	}
+
+	if (ph->count < ph->size) 
+	{
+		/* sift up */
+		i = ph->count++;
+		ph->items[i] = ticket;
+
+		while (i > 0 && compareTopTickets(&ph->items[(i-1)/2], &ph->items[i]) < 0) {
+			tmp = ph->items[i];
+			ph->items[i] = ph->items[(i-1)/2];
+			ph->items[(i-1)/2] = tmp;
+			i = (i-1)/2;
+		}
+
+		return;
+	}
+
+	if (compareTopTickets(&ticket, &ph->items[0]) >= 0) return;
+
+	/* the worst ticket is replaced, sift down */
+	ph->items[0] = ticket;
+
+	for (i=0; (c = 2*i+1) < ph->count; i=c)
+	{
+		if (c+1 < ph->count && compareTopTickets(&ph->items[c+1], &ph->items[c]) > 0) c++;
+		if (compareTopTickets(&ph->items[c], &ph->items[i]) <= 0) break;
+
+		tmp = ph->items[i];
+		ph->items[i] = ph->items[c];
+		ph->items[c] = tmp;
+	}
+}
+
+
+
+int compareTopTickets(const void *p1, const void *p2)
+{
+	struct TopTicket *t1 = (struct TopTicket *) p1;
+	struct TopTicket *t2 = (struct TopTicket *) p2;
+
+	if (t1->score != t2->score) return t1->score > t2->score ? -1 : 1;
+	if (t1->rank != t2->rank) return t1->rank < t2->rank ? -1 : 1;
+
+	return 0;
+}
+
+
+
+UINT32 scoreTicketsFile(char *fileName, FILE *fp)
+{
+	struct TicketScore ts;
+	UINTROW ballDraws[TOTAL_BALL+1];
+	UINT32 binom[(TOTAL_BALL+1)*(DRAW_BALL+1)];
+	UINT32 length, line, tickets = 0;
+	int fields[DRAW_BALL+1];
+	char *buf, *pos, *end, *p, *q, *outBuf;
+	UINT8 balls[DRAW_BALL];
+	UINT8 i, j, n, tmp, valid;
+	UINT8 daysWidth[5] = {0, 0, 10, 12, 13};
+
+	if ((buf = mapFile(fileName, &length)) == NULL) return 0;
+
+	if ((outBuf = (char *) malloc(SCOREBUF)) == NULL) {
+		unmapFile(buf, length);
+		return 0;
+	}
+
+	end = buf + length;
+
+	for (i=0; i <= TOTAL_BALL; i++) {
+		ballDraws[i] = 0;
+
+		for (j=0; j <= DRAW_BALL; j++) {
+			binom[i*(DRAW_BALL+1)+j] = combCount(i, j);
+		}
+	}
+
+	for (i=0; i < winningBallsDrawCount->index; i++) {
+		ballDraws[winningBallsDrawCount->balls[i]] = winningBallsDrawCount->vals[i];
+	}
+
+	fprintf(fp, "%-*s  %7s%7s%8s%9s%10s%12s%13s\n\n", DRAW_BALL*3, "Numbers", "Draws", "Pairs", "Triples", "Quartets", "PairDays", "TripleDays", "QuartetDays");
+
+	/* score rows are written to the buffer and the buffer is written when it is full */
+
+	for (pos=buf, p=outBuf, line=1; pos<end; line++)
+	{
+		/* blank lines are skipped, a line with no balls is an invalid ticket */
+
+		for (q=pos; q < end && (*q == ' ' || *q == '\t' || *q == '\r'); q++);
+
+		n = parseLine(&pos, end, fields, DRAW_BALL+1);
+
+		if (q == end || *q == '\n') continue;
+
+		if (p - outBuf > SCOREBUF-120) {
+			fwrite(outBuf, 1, (size_t) (p - outBuf), fp);
+			p = outBuf;
+		}
+
+		tickets++;
+		valid = (n == DRAW_BALL);
+
+		for (i=0; valid && i<DRAW_BALL; i++) {
+			if (fields[i] < 1 || fields[i] > TOTAL_BALL) valid = 0;
+			else balls[i] = (UINT8) fields[i];
+		}
+
+		if (valid)
+		{
+			for (i=1; i<DRAW_BALL; i++) {
+				for (j=i; j>0 && balls[j-1] > balls[j]; j--) {
+					tmp = balls[j];
+					balls[j] = balls[j-1];
+					balls[j-1] = tmp;
+				}
+			}
+
+			for (i=1; i<DRAW_BALL; i++) {
+				if (balls[i] == balls[i-1]) valid = 0;
+			}
+		}
+
+		if (!valid) {
+			p += sprintf(p, "invalid ticket (line %lu)\n", (unsigned long) line);
+			continue;
+		}
+
+		scoreTicket(balls, ballDraws, binom, &ts);
+
+		for (i=0; i<DRAW_BALL; i++) {
+			p = putNumber(p, balls[i], 2);
+			*p++ = ' ';
+		}
+
+		*p++ = ' ';
+		p = putNumber(p, ts.draws, 7);
+		p = putNumber(p, ts.found[2], 7);
+		p = putNumber(p, ts.found[3], 8);
+		p = putNumber(p, ts.found[4], 9);
+
+		for (i=2; i<=4; i++)
+		{
+			if (ts.days[i] < 0) {
+				for (j=1; j < daysWidth[i]; j++) *p++ = ' ';
+				*p++ = '-';
+			} else {
+				p = putNumber(p, (UINT32) ts.days[i], daysWidth[i]);
+			}
+		}
+
+		*p++ = '\n';
+	}
+
+	fwrite(outBuf, 1, (size_t) (p - outBuf), fp);
+
+	free(outBuf);
+	unmapFile(buf, length);
+
+	return tickets;
+}
+
+
+
+void scoreTicket(UINT8 *balls, UINTROW *ballDraws, UINT32 *binom, struct TicketScore *ts)
+{
+	struct LuckyComb *lc;
+	UINT32 rank[5][DRAW_BALL];
+	UINT32 rank2, rank3;
+	UINT8 i, j, k, l;
+
+	ts->draws = 0;
+
+	for (i=2; i<=4; i++) {
+		ts->found[i] = 0;
+		ts->days[i] = -1;
+	}
+
+	/* rank of a combination is the sum of the ranks of its balls at their places (colexicographic order) */
+
+	for (i=0; i<DRAW_BALL; i++) 
+	{
+		ts->draws += ballDraws[balls[i]];
+
+		for (j=1; j<=4; j++) {
+			rank[j][i] = binom[(balls[i]-1)*(DRAW_BALL+1) + j];
 		}
+	}
+
+	if (luckyIndex[2] == NULL) return;
+
+	/* 
+	 * Lucky combinations are drawn together at least twice, so the pairs of a lucky triple and the triples of a lucky quartet
+	 * are lucky too. The triples are searched only after a lucky pair and the quartets only after a lucky triple.
+	 */
+
+	for (i=0; i<DRAW_BALL-1; i++)
+	{
+		for (j=i+1; j<DRAW_BALL; j++)
+		{
+			rank2 = rank[1][i] + rank[2][j];
+
+			if ((lc = getLuckyRank(luckyIndex[2], rank2, 0)) == NULL) continue;
+
+			ts->found[2]++;
+			setTicketDays(ts, 2, lc);
+
+			if (luckyIndex[3] == NULL) continue;
+
+			for (k=j+1; k<DRAW_BALL; k++)
+			{
+				rank3 = rank2 + rank[3][k];
+
+				if ((lc = getLuckyRank(luckyIndex[3], rank3, 0)) == NULL) continue;
+
+				ts->found[3]++;
+				setTicketDays(ts, 3, lc);
+
+				if (luckyIndex[4] == NULL) continue;
+
+				for (l=k+1; l<DRAW_BALL; l++)
+				{
+					if ((lc = getLuckyRank(luckyIndex[4], rank3 + rank[4][l], 0)) == NULL) continue;
+
+					ts->found[4]++;
+					setTicketDays(ts, 4, lc);
+				}
+			}
+		}
+	}
+}
+
+
+
+void setTicketDays(struct TicketScore *ts, UINT8 comb, struct LuckyComb *lc)
+{
+	SINT32 days = (SINT32) currEpochDay - (SINT32) lc->epochDay;
+
+	if (ts->days[comb] < 0 || days < ts->days[comb]) ts->days[comb] = days;
+}
+
+
+
+void backtest(UINTROW draws, FILE *fp)
+{
+	UINT32 hits[8*(DRAW_BALL+1)];
+	UINT32 rows, matched;
+	UINT16 workers = 1;
+	UINT8 mode, k;
+	UINT8 ok = 1;
+	char *modes[8] = {"", "normal distribution", "left stacked", "blend 1", "blend 2", "side stacked", "random", "lucky"};
+	char date1[11], date2[11];
+	double expected;
+	#ifdef USE_THREADS
+	UINT32 part[8*(DRAW_BALL+1)];
+	UINTROW first, last;
+	UINT16 w, started = 0;
+	int fd[64][2];
+	pid_t pid[64];
+	#endif
+
+	if (draws > winningDrawnBallsList->rows-1) draws = winningDrawnBallsList->rows-1;
+	if (draws == 0) return;
+
+	for (k=0; k < 8*(DRAW_BALL+1); k++) {
+		hits[k] = 0;
+	}
+
+	#ifdef USE_THREADS
+	workers = drawThreads ? drawThreads : (UINT16) sysconf(_SC_NPROCESSORS_ONLN);
+	if (workers < 1) workers = 1;
+	if (workers > 64) workers = 64;
+	if (workers > draws) workers = draws;
+	#endif
+
+	formatDate(date1, winningDrawnBallsList->day[draws-1], winningDrawnBallsList->mon[draws-1], winningDrawnBallsList->year[draws-1]);
+	formatDate(date2, winningDrawnBallsList->day[0], winningDrawnBallsList->mon[0], winningDrawnBallsList->year[0]);
+
+	if (fp != stdout) printf("%lu draws (%s - %s) are replayed...\n", (unsigned long) draws, date1, date2);
+
+	/* the rows are drawn one by one in a worker */
+	drawThreads = 0;
+	showProgress = 0;
+
+	#ifdef USE_THREADS
+	/* every worker process replays a block of the draws and writes its hits to a pipe */
+
+	for (w=0; w < workers; w++)
+	{
+		first = (UINTROW) ((UINT32) draws*w/workers);
+		last = (UINTROW) ((UINT32) draws*(w+1)/workers - 1);
+
+		if (pipe(fd[w]) != 0) break;
+
+		if ((pid[w] = fork()) < 0) {
+			close(fd[w][0]);
+			close(fd[w][1]);
+			break;
+		}
+
+		if (pid[w] == 0) 
+		{
+			close(fd[w][0]);
+			if (!backtestDraws(first, last, part)) _exit(1);
+			if (write(fd[w][1], part, sizeof(part)) != (ssize_t) sizeof(part)) _exit(1);
+			_exit(0);
+		}
+
+		close(fd[w][1]);
+		started++;
+	}
+
+	for (w=0; w < started; w++)
+	{
+		if (read(fd[w][0], part, sizeof(part)) == (ssize_t) sizeof(part)) {
+			for (k=0; k < 8*(DRAW_BALL+1); k++) hits[k] += part[k];
+		} else {
+			ok = 0;
+		}
+
+		close(fd[w][0]);
+		waitpid(pid[w], NULL, 0);
+	}
+
+	/* draws left if a worker couldn't be started */
+
+	if (started < workers) 
+	{
+		if (backtestDraws((UINTROW) ((UINT32) draws*started/workers), draws-1, part)) {
+			for (k=0; k < 8*(DRAW_BALL+1); k++) hits[k] += part[k];
+		} else {
+			ok = 0;
+		}
+	}
+	#else
+	ok = backtestDraws(0, draws-1, hits);
+	#endif
+
+	if (!ok) {
+		puts("There is not enough memory for the backtest!");
+		return;
+	}
+
+	fprintf(fp, "Backtest of the latest %lu draws (%s - %s), %d rows of each draw mode for every draw\n\n", (unsigned long) draws, date1, date2, BACKTESTROWS);
+	fprintf(fp, "%-22s", "Matched numbers");
+
+	for (k=0; k <= DRAW_BALL; k++) {
+		fprintf(fp, "%8d", k);
+	}
+
+	fprintf(fp, "   Average\n\n");
+
+	for (mode=1; mode <= 7; mode++)
+	{
+		for (k=0, rows=0, matched=0; k <= DRAW_BALL; k++) {
+			rows += hits[mode*(DRAW_BALL+1)+k];
+			matched += hits[mode*(DRAW_BALL+1)+k] * k;
+		}
+
+		if (rows == 0) continue;
+
+		fprintf(fp, "%-22s", modes[mode]);
+
+		for (k=0; k <= DRAW_BALL; k++) {
+			fprintf(fp, "%7.2f%%", 100.0 * hits[mode*(DRAW_BALL+1)+k] / rows);
+		}
+
+		fprintf(fp, "%10.4f\n", (double) matched / rows);
+	}
+
+	/* hypergeometric probabilities of a random row */
+
+	fprintf(fp, "\n%-22s", "expected (random)");
+
+	for (k=0; k <= DRAW_BALL; k++) {
+		expected = (double) combCount(DRAW_BALL, k) * combCount(TOTAL_BALL-DRAW_BALL, DRAW_BALL-k) / combCount(TOTAL_BALL, DRAW_BALL);
+		fprintf(fp, "%7.2f%%", 100.0 * expected);
+	}
+
+	fprintf(fp, "%10.4f\n", (double) DRAW_BALL * DRAW_BALL / TOTAL_BALL);
+	fprintf(fp, "\nSeed: %lu\n", (unsigned long) randomSeed);
+}
+
+
+
+UINT8 backtestDraws(UINTROW latest, UINTROW oldest, UINT32 *hits)
+{
+	struct TableXY *pt = winningDrawnBallsList;
+	struct CombTable *combTables[5] = {NULL, NULL, NULL, NULL, NULL};
+	struct ListXY *coupon = NULL;
+	struct ListXY *luckyLists[5] = {NULL, NULL, NULL, NULL, NULL};
+	struct ListX *nl;
+	UINTROW ballCounts[TOTAL_BALL+1];
+	UINT8 drawn[TOTAL_BALL+1];
+	UINTROW r;
+	UINT32 today = currEpochDay;
+	UINTDAY days = drawnDays;
+	UINT8 i, k, comb, mode, matched;
+	UINT8 ok = 1;
+
+	for (i=0; i < 8*(DRAW_BALL+1); i++) {
+		hits[i] = 0;
+	}
+
+	for (i=0; i <= TOTAL_BALL; i++) {
+		ballCounts[i] = 0;
+		drawn[i] = 0;
+	}
+
+	for (comb=2; comb<=4; comb++) 
+	{
+		if ((combTables[comb] = createCombTable(combTables[comb], comb, TOTAL_BALL, (UINT32) pt->rows*combCount(pt->cols, comb))) == NULL) 
+		{
+			for (; comb>2; comb--) {
+				removeAllC(combTables[comb-1]);
+				free(combTables[comb-1]);
+			}
+
+			return 0;
+		}
+	}
+
+	luckyLists[2] = luckyBalls2;
+	luckyLists[3] = luckyBalls3;
+	luckyLists[4] = luckyBalls4;
+
+	for (comb=2; comb<=4; comb++) 
+	{
+		removeAllXY(luckyLists[comb]);
+		removeLuckyIndex(luckyIndex[comb]);
+		luckyIndex[comb] = NULL;
+	}
+
+	removeLuckyPartners(luckyPartners2);
+	removeLuckyPartners(luckyPartners3);
+	luckyPartners2 = luckyPartners3 = NULL;
+
+	coupon = createListXY(coupon);
+
+	/* draws older than the oldest draw replayed */
+
+	for (r=pt->rows-1; r > oldest; r--) 
+	{
+		for (i=0; i<pt->cols; i++) {
+			ballCounts[pt->balls[(UINT32) r*pt->cols + i]]++;
+		}
+
+		for (comb=2; comb<=4; comb++) {
+			if (!countCombRowT(pt, combTables[comb], r)) ok = 0;
+		}
+	}
+
+	for (r=oldest; ok; r--)
+	{
+		/* statistics of the draws before the draw r */
+
+		removeAllX2(winningBallsDrawCount);
+
+		for (i=1; i <= TOTAL_BALL; i++) {
+			appendItem2(winningBallsDrawCount, i, ballCounts[i]);
+		}
+
+		for (comb=2; comb<=4; comb++) {
+			removeAllXY(luckyLists[comb]);
+			getCombCountList(luckyLists[comb], combTables[comb], pt);
+			luckyIndex[comb] = createLuckyIndex(luckyIndex[comb], luckyLists[comb], comb, TOTAL_BALL);
+		}
+
+		luckyPartners2 = createLuckyPartners(luckyPartners2, luckyBalls2, 2, TOTAL_BALL);
+		luckyPartners3 = createLuckyPartners(luckyPartners3, luckyBalls3, 3, TOTAL_BALL);
+
+		/* the day of the draw r is today, the lucky numbers are due by the days of the draws before it */
+		currEpochDay = pt->epochDay[r];
+		drawnDays = pt->epochDay[r+1] - pt->epochDay[pt->rows-1];
+
+		for (i=0; i<pt->cols; i++) {
+			drawn[pt->balls[(UINT32) r*pt->cols + i]] = 1;
+		}
+
+		/* rows of the draw modes (the stream of the draw does not depend on the worker) */
+
+		seedRandom(&rng, randomSeed, (UINT32) r);
+
+		for (mode=1; mode <= 7; mode++)
+		{
+			/* coupon, totalBall, drawBallCount, drawRowCount, drawByNorm, left, blend1, blend2, side, rand, lucky */
+			drawBalls(coupon, TOTAL_BALL, DRAW_BALL, BACKTESTROWS, mode == 1, mode == 2, mode == 3, mode == 4, mode == 5, mode == 6, mode == 7);
+
+			for (nl=coupon->list; nl; nl=nl->next) 
+			{
+				for (k=0, matched=0; k < nl->index; k++) {
+					matched += drawn[nl->balls[k]];
+				}
+
+				hits[mode*(DRAW_BALL+1) + matched]++;
+			}
+
+			removeAllXY(coupon);
+		}
+
+		for (i=0; i<pt->cols; i++) {
+			drawn[pt->balls[(UINT32) r*pt->cols + i]] = 0;
+			ballCounts[pt->balls[(UINT32) r*pt->cols + i]]++;
+		}
+
+		for (comb=2; comb<=4; comb++) {
+			removeLuckyIndex(luckyIndex[comb]);
+			luckyIndex[comb] = NULL;
+			if (!countCombRowT(pt, combTables[comb], r)) ok = 0;
+		}
+
+		removeLuckyPartners(luckyPartners2);
+		removeLuckyPartners(luckyPartners3);
+		luckyPartners2 = luckyPartners3 = NULL;
+
+		if (r == latest) break;
+	}
+
+	currEpochDay = today;
+	drawnDays = days;
+
+	for (comb=2; comb<=4; comb++) {
+		removeAllC(combTables[comb]);
+		free(combTables[comb]);
+	}
+
+	free(coupon);
+
+	return ok;
+}
+
+
+
+char *putNumber(char *buf, UINT32 num, UINT8 width)
+{
+	char digits[10];
+	UINT8 n = 0;
+
+	do {
+		digits[n++] = (char) ('0' + num % 10);
+		num /= 10;
+	} while (num);
+
+	for (; width > n; width--) *buf++ = ' ';
+
+	while (n) *buf++ = digits[--n];
+
+	return buf;
+}
+
+
+
+void printDrawnBallCount(struct ListX2 *ballSortOrder)
+{
+	UINT8 i;
+
+#ifdef __MSDOS__
+	UINT8 col = 10;
+#else
+	UINT8 col = 15;
+#endif
+
+	for (i=0; i < ballSortOrder->index; i++) 
+	{
+		printf("%2d:%3d", ballSortOrder->balls[i], ballSortOrder->vals[i]);
+
+		if ((i+1) % col == 0) puts("");
+		else printf("  ");
+	}
+}
+
+
+
+void printLuckyBalls(struct ListXY *pl, FILE *fp)
+{
+	struct ListX *nl = NULL;
+	UINTROW i = 0;
+	UINT8 j;
+	UINT8 col, len;
+	char ioBuf[50];
+	char buf[20];
+
+	 if (pl == NULL || pl->list == NULL) 
+	 {
+		puts("No matched found.\n");
+		if (fp != NULL) fputs("No matched found.\n", fp);
+
+		return;
+	 }
+
+	nl = pl->list;
+	len = nl->index;
+
+#ifdef __MSDOS__
+	col = 6-len;
+	if (col<3) col = 3;
+#else
+	col = 8-len;
+#endif
+
+	while (nl)
+	{
+		ioBuf[0] = '\0';
+		
+		for (j=0; j < nl->index; j++) {
+			sprintf(buf, "%2d ", nl->balls[j]);
+			strcat(ioBuf, buf);
+		}
+
+		sprintf(buf, ": %2d times", nl->val);
+		strcat(ioBuf, buf);
+
+		if ((i+1) % col == 0) {
+			strcat(ioBuf, "\n");
+		} else {
+			strcat(ioBuf, "    ");
+		}
+
+		i++;
+		nl = nl->next;
+
+		printf("%s", ioBuf);
+		if (fp != NULL) fprintf(fp, "%s", ioBuf);
+	}
+}
+
+
+
+UINTROW numberOfTerm(UINTROW sum)
+{
+	UINTROW n;
+	SINT32 sum2 = (SINT32) sum;
+
+	for (n=0; sum2>0; n++) 
+	{
+		sum2 = sum2 - (n+1);
+	}
+
+	return n;
+}
+
+
+
+void seedRandom(struct Random *r, UINT32 seed, UINT32 stream)
+{
+	UINT32 z;
+	UINT8 i;
+
+	/* splitmix32 fills the state from the seed */
+
+	for (i=0; i<4; i++) {
+		seed += 0x9e3779b9UL;
+		z = seed;
+		z = (z ^ (z >> 16)) * 0x85ebca6bUL;
+		z = (z ^ (z >> 13)) * 0xc2b2ae35UL;
+		r->s[i] = (z ^ (z >> 16)) & 0xffffffffUL;
+	}
+
+	if (!(r->s[0] | r->s[1] | r->s[2] | r->s[3])) r->s[0] = 1;
+
+	for (; stream > 0; stream--) {
+		jumpRandom(r);
+	}
+}
+
+
+
+void jumpRandom(struct Random *r)
+{
+	static const UINT32 jump[4] = { 0x8764000bUL, 0xf542d2d3UL, 0x6fa035c3UL, 0x77f2db5bUL };
+	UINT32 t[4];
+	UINT8 i, b;
+
+	t[0] = t[1] = t[2] = t[3] = 0;
+
+	for (i=0; i<4; i++) {
+		for (b=0; b<32; b++) {
+			if (jump[i] & ((UINT32) 1 << b)) {
+				t[0] ^= r->s[0];
+				t[1] ^= r->s[1];
+				t[2] ^= r->s[2];
+				t[3] ^= r->s[3];
+			}
+			nextRandom(r);
+		}
+	}
+
+	r->s[0] = t[0];
+	r->s[1] = t[1];
+	r->s[2] = t[2];
+	r->s[3] = t[3];
+}
+
+
+
+UINT32 nextRandom(struct Random *r)
+{
+	UINT32 x = (r->s[1] * 5) & 0xffffffffUL;
+	UINT32 t = (r->s[1] << 9) & 0xffffffffUL;
+
+	x = (((x << 7) | (x >> 25)) * 9) & 0xffffffffUL;
+
+	r->s[2] ^= r->s[0];
+	r->s[3] ^= r->s[1];
+	r->s[1] ^= r->s[2];
+	r->s[0] ^= r->s[3];
+	r->s[2] ^= t;
+	r->s[3] = ((r->s[3] << 11) | (r->s[3] >> 21)) & 0xffffffffUL;
+
+	return x;
+}
+
+
+
+UINT32 randomBelow(struct Random *r, UINT32 n)
+{
+	UINT32 x, threshold;
+
+	if (n < 2) return 0;
+
+	/* numbers below threshold would make the small results more likely */
+
+	threshold = (((UINT32) 0 - n) & 0xffffffffUL) % n;
+
+	do {
+		x = nextRandom(r);
+	} while (x < threshold);
+
+	return x % n;
+}
+
+
+
+double randomUnit(struct Random *r)
+{
+	return nextRandom(r) * (1.0 / 4294967296.0);
+}
+
+
+
+struct AliasTable *createGaussTable(UINT8 ballCount)
+{
+	struct AliasTable *at;
+	double *scaled;
+	UINT8 *small, *large;
+	UINT8 nSmall=0, nLarge=0, s, l;
+	double p = 0.505, q = 0.495;
+	UINT16 k;
+
+	if ((at = (struct AliasTable *) malloc(sizeof(struct AliasTable))) == NULL) return NULL;
+
+	at->prob = (double *) malloc(sizeof(double)*ballCount);
+	at->alias = (UINT8 *) malloc(sizeof(UINT8)*ballCount);
+	at->size = ballCount;
+	scaled = (double *) malloc(sizeof(double)*ballCount);
+	small = (UINT8 *) malloc(sizeof(UINT8)*ballCount);
+	large = (UINT8 *) malloc(sizeof(UINT8)*ballCount);
+
+	if (at->prob == NULL || at->alias == NULL || scaled == NULL || small == NULL || large == NULL) {
+		free(at->prob);
+		free(at->alias);
+		free(at);
+		free(scaled);
+		free(small);
+		free(large);
+		return NULL;
+	}
+
+	/* binomial probabilities (multiplied by ballCount) */
+
+	scaled[0] = pow(q, ballCount-1) * ballCount;
+
+	for (k=1; k<ballCount; k++) {
+		scaled[k] = scaled[k-1] * (ballCount-k) / k * p / q;
+	}
+
+	for (k=0; k<ballCount; k++) {
+		if (scaled[k] < 1.0) small[nSmall++] = (UINT8) k;
+		else large[nLarge++] = (UINT8) k;
+	}
+
+	while (nSmall && nLarge)
+	{
+		s = small[--nSmall];
+		l = large[--nLarge];
+
+		at->prob[s] = scaled[s];
+		at->alias[s] = l;
+
+		scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+
+		if (scaled[l] < 1.0) small[nSmall++] = l;
+		else large[nLarge++] = l;
+	}
+
+	/* remaining columns are full (up to rounding errors) */
+
+	while (nLarge) {
+		l = large[--nLarge];
+		at->prob[l] = 1.0;
+		at->alias[l] = l;
+	}
+
+	while (nSmall) {
+		s = small[--nSmall];
+		at->prob[s] = 1.0;
+		at->alias[s] = s;
+	}
+
+	free(scaled);
+	free(small);
+	free(large);
+
+	return at;
+}
+
+
+
+UINT8 gaussIndex(UINT8 ballCount)
+{
+	UINT16 node=0, leftnode=0, level;
+	struct AliasTable *at;
+	UINT8 col;
+
+	if (ballCount < 2) return 1;
+
+	if ((at = gaussTables[ballCount]) == NULL) {
+		at = gaussTables[ballCount] = createGaussTable(ballCount);
+	}
+
+	if (at != NULL) 
+	{
+		col = (UINT8) randomBelow(&rng, ballCount);
+
+		if (randomUnit(&rng) < at->prob[col]) {
+			return col + 1;
+		}
+
+		return at->alias[col] + 1;
+	}
+
+	/* not enough memory for the alias table, drop the ball on the triangle */
+
+	for (level=1; level<ballCount; level++)
+	{
+		if (randomBelow(&rng, 100) < 49 + randomBelow(&rng, 2)) {
+			node = node + level;
+		} else {
+			node = node + level + 1;
+		}
+
+		leftnode = leftnode + level;
+	}
+
+	return node - (leftnode-1);
+}
+
+
+
+UINT8 search5CombXY(struct ListXY *prvDrawnsList, struct ListX *drawnBalls)
+{
+	UINT16 i, listRows;
+	UINT8 balls[DRAW_BALL+1];
+	struct ListX *aPrvDrawn = NULL;
+	UINT8 found = 0;
+
+	listRows = lengthY(prvDrawnsList);
+
+	getKeys(drawnBalls, balls, 0, 0);
+
+	aPrvDrawn = prvDrawnsList->list;
+
+	for (i=0; aPrvDrawn && i<listRows; i++) 
+	{
+		if (aPrvDrawn->balls[0] <= balls[0] && seqSearchX(aPrvDrawn, balls, 5) == 5) {
+			found=1;
+			break;
+		}
+
+		aPrvDrawn = aPrvDrawn->next;
+	}
+
+	return found;
+}
+
+
+
+UINT8 search5CombX(struct ListX *aPrvDrawn, struct ListX *drawnBalls)
+{
+	return searchCombX(aPrvDrawn, drawnBalls, NULL, NULL, 5);
+}
+
+
+
+UINT8 search4CombXY(struct ListXY *prvDrawnsList, struct ListX *drawnBalls, struct ListXY *foundComb)
+{
+	UINT16 i, listRows;
+	UINT8 b1[DRAW_BALL+1];
+	UINT8 b2[5];
+	struct ListX *aPrvDrawn = NULL;
+	struct ListX *fc = NULL;
+	UINT8 found = 0;
+
+	listRows = lengthY(prvDrawnsList);
+
+	getKeys(drawnBalls, b1, 0, drawnBalls->size);
+
+	if (foundComb != NULL) removeAllXY(foundComb);
+
+	aPrvDrawn = prvDrawnsList->list;
+
+	for (i=0; aPrvDrawn && i<listRows; i++)
+	{
+		b2[0] = b1[0];
+		b2[1] = b1[1];
+		b2[2] = b1[2];
+		b2[3] = b1[3];
+		b2[4] = '\0';
+
+		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 4) == 4) 
+		{
+			found++; 
+
+			if (foundComb == NULL) {
+				break;
+			} else {
+				fc = createListX(fc, 4, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
+				appendItems(fc, b2);
+				appendList(foundComb, fc);
+			}
+		}
+
+		//b2[0] = b1[0];
+		//b2[1] = b1[1];
+		//b2[2] = b1[2];
+		b2[3] = b1[4];
+		//b2[4] = '\0';
+
+		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 4) == 4) 
+		{
+			found++; 
+
+			if (foundComb == NULL) {
+				break;
+			} else {
+				fc = createListX(fc, 4, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
+				appendItems(fc, b2);
+				appendList(foundComb, fc);
+			}
+		}
+
+
+		//b2[0] = b1[0];
+		//b2[1] = b1[1];
+		b2[2] = b1[3];
+		//b2[3] = b1[4];
+		//b2[4] = '\0';
+
+		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 4) == 4) 
+		{
+			found++; 
+
+			if (foundComb == NULL) {
+				break;
+			} else {
+				fc = createListX(fc, 4, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
+				appendItems(fc, b2);
+				appendList(foundComb, fc);
+			}
+		}
+
+
+		//b2[0] = b1[0];
+		b2[1] = b1[2];
+		//b2[2] = b1[3];
+		//b2[3] = b1[4];
+		//b2[4] = '\0';
+
+		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 4) == 4) 
+		{
+			found++; 
+
+			if (foundComb == NULL) {
+				break;
+			} else {
+				fc = createListX(fc, 4, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
+				appendItems(fc, b2);
+				appendList(foundComb, fc);
+			}
+		}
+
+
+		b2[0] = b1[1];
+		//b2[1] = b1[2];
+		//b2[2] = b1[3];
+		//b2[3] = b1[4];
+		//b2[4] = '\0';
+
+		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 4) == 4) 
+		{
+			found++; 
+
+			if (foundComb == NULL) {
+				break;
+			} else {
+				fc = createListX(fc, 4, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
+				appendItems(fc, b2);
+				appendList(foundComb, fc);
+			}
+		}
+
+		aPrvDrawn = aPrvDrawn->next;
+	}
+
+	return found;
+}
+
+
+
+UINT8 search4CombX(struct ListX *aPrvDrawn, struct ListX *drawnBalls, struct ListXY *luckyBalls, char *buf)
+{
+	return searchCombX(aPrvDrawn, drawnBalls, luckyBalls, buf, 4);
+}
+
+
+
+UINT8 search3CombXY(struct ListXY *prvDrawnsList, struct ListX *drawnBalls, struct ListXY *foundComb)
+{
+	UINT16 i, listRows;
+	UINT8 b1[DRAW_BALL+1];
+	UINT8 b2[4];
+	struct ListX *aPrvDrawn = NULL;
+	struct ListX *fc = NULL;
+	UINT8 found = 0;
+
+	listRows = lengthY(prvDrawnsList);
+
+	getKeys(drawnBalls, b1, 0, drawnBalls->size);
+
+	if (foundComb != NULL) removeAllXY(foundComb);
+
+	aPrvDrawn = prvDrawnsList->list;
+
+	for (i=0; aPrvDrawn && i<listRows; i++)
+	{
+		b2[0] = b1[0];
+		b2[1] = b1[1];
+		b2[2] = b1[2];
+		b2[3] = '\0';
+
+		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 3) == 3) 
+		{
+			found++; 
+
+			if (foundComb == NULL) {
+				break;
+			} else {
+				fc = createListX(fc, 3, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
+				appendItems(fc, b2);
+				appendList(foundComb, fc);
+			}
+		}
+
+		//b2[0] = b1[0];
+		//b2[1] = b1[1];
+		b2[2] = b1[3];
+		//b2[3] = '\0';
+
+		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 3) == 3) 
+		{
+			found++; 
+
+			if (foundComb == NULL) {
+				break;
+			} else {
+				fc = createListX(fc, 3, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
+				appendItems(fc, b2);
+				appendList(foundComb, fc);
+			}
+		}
+
+		//b2[0] = b1[0];
+		//b2[1] = b1[1];
+		b2[2] = b1[4];
+		//b2[3] = '\0';
+
+		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 3) == 3) 
+		{
+			found++; 
+
+			if (foundComb == NULL) {
+				break;
+			} else {
+				fc = createListX(fc, 3, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
+				appendItems(fc, b2);
+				appendList(foundComb, fc);
+			}
+		}
+
+
+		//b2[0] = b1[0];
+		b2[1] = b1[2];
+		b2[2] = b1[3];
+		//b2[3] = '\0';
+
+		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 3) == 3) 
+		{
+			found++; 
+
+			if (foundComb == NULL) {
+				break;
+			} else {
+				fc = createListX(fc, 3, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
+				appendItems(fc, b2);
+				appendList(foundComb, fc);
+			}
+		}
+
+		//b2[0] = b1[0];
+		//b2[1] = b1[2];
+		b2[2] = b1[4];
+		//b2[3] = '\0';
+
+		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 3) == 3) 
+		{
+			found++; 
+
+			if (foundComb == NULL) {
+				break;
+			} else {
+				fc = createListX(fc, 3, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
+				appendItems(fc, b2);
+				appendList(foundComb, fc);
+			}
+		}
+
+
+		//b2[0] = b1[0];
+		b2[1] = b1[3];
+		//b2[2] = b1[4];
+		//b2[3] = '\0';
+
+		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 3) == 3) 
+		{
+			found++; 
+
+			if (foundComb == NULL) {
+				break;
+			} else {
+				fc = createListX(fc, 3, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
+				appendItems(fc, b2);
+				appendList(foundComb, fc);
+			}
+		}
+
+
+		b2[0] = b1[1];
+		b2[1] = b1[2];
+		b2[2] = b1[3];
+		//b2[3] = '\0';
+
+		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 3) == 3) 
+		{
+			found++; 
+
+			if (foundComb == NULL) {
+				break;
+			} else {
+				fc = createListX(fc, 3, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
+				appendItems(fc, b2);
+				appendList(foundComb, fc);
+			}
+		}
+
+		//b2[0] = b1[1];
+		//b2[1] = b1[2];
+		b2[2] = b1[4];
+		//b2[3] = '\0';
+
+		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 3) == 3) 
+		{
+			found++; 
+
+			if (foundComb == NULL) {
+				break;
+			} else {
+				fc = createListX(fc, 3, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
+				appendItems(fc, b2);
+				appendList(foundComb, fc);
+			}
+		}
+
+
+		//b2[0] = b1[1];
+		b2[1] = b1[3];
+		//b2[2] = b1[4];
+		//b2[3] = '\0';
+
+		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 3) == 3) 
+		{
+			found++; 
+
+			if (foundComb == NULL) {
+				break;
+			} else {
+				fc = createListX(fc, 3, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
+				appendItems(fc, b2);
+				appendList(foundComb, fc);
+			}
+		}
+
+
+		b2[0] = b1[2];
+		//b2[1] = b1[3];
+		//b2[2] = b1[4];
+		//b2[3] = '\0';
+
+		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 3) == 3) 
+		{
+			found++; 
+
+			if (foundComb == NULL) {
+				break;
+			} else {
+				fc = createListX(fc, 3, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
+				appendItems(fc, b2);
+				appendList(foundComb, fc);
+			}
+		}
+
+		aPrvDrawn = aPrvDrawn->next;
+	}
+
+	return found;
+}
+
+
+
+UINT8 search3CombX(struct ListX *aPrvDrawn, struct ListX *drawnBalls, struct ListXY *luckyBalls, char *buf)
+{
+	return searchCombX(aPrvDrawn, drawnBalls, luckyBalls, buf, 3);
+}
+
+
+
+UINT8 search2CombXY(struct ListXY *prvDrawnsList, struct ListX *drawnBalls, struct ListXY *foundComb)
+{
+	UINT16 i, listRows;
+	UINT8 b1[DRAW_BALL+1];
+	UINT8 b2[3];
+	struct ListX *aPrvDrawn = NULL;
+	struct ListX *fc = NULL;
+	UINT8 found = 0;
+
+	listRows = lengthY(prvDrawnsList);
+
+	getKeys(drawnBalls, b1, 0, drawnBalls->size);
+
+	if (foundComb != NULL) removeAllXY(foundComb);
+
+	aPrvDrawn = prvDrawnsList->list;
+
+	for (i=0; aPrvDrawn && i<listRows; i++) 
+	{
+		b2[0] = b1[0];
+		b2[1] = b1[1];
+		b2[2] = '\0';
+
+		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 2) == 2) 
+		{
+			found++; 
+
+			if (foundComb == NULL) {
+				break;
+			} else {
+				fc = createListX(fc, 2, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
+				appendItems(fc, b2);
+				appendList(foundComb, fc);
+			}
+		}
+
+		//b2[0] = b1[0];
+		b2[1] = b1[2];
+		//b2[2] = '\0';
+
+		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 2) == 2) 
+		{
+			found++; 
+
+			if (foundComb == NULL) {
+				break;
+			} else {
+				fc = createListX(fc, 2, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
+				appendItems(fc, b2);
+				appendList(foundComb, fc);
+			}
+		}
+
+		//b2[0] = b1[0];
+		b2[1] = b1[3];
+		//b2[2] = '\0';
+
+		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 2) == 2) 
+		{
+			found++; 
+
+			if (foundComb == NULL) {
+				break;
+			} else {
+				fc = createListX(fc, 2, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
+				appendItems(fc, b2);
+				appendList(foundComb, fc);
+			}
+		}
+
+		//b2[0] = b1[0];
+		b2[1] = b1[4];
+		//b2[2] = '\0';
+
+		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 2) == 2) 
+		{
+			found++; 
+
+			if (foundComb == NULL) {
+				break;
+			} else {
+				fc = createListX(fc, 2, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
+				appendItems(fc, b2);
+				appendList(foundComb, fc);
+			}
+		}
+
+
+		b2[0] = b1[1];
+		b2[1] = b1[2];
+		//b2[2] = '\0';
+
+		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 2) == 2) 
+		{
+			found++; 
+
+			if (foundComb == NULL) {
+				break;
+			} else {
+				fc = createListX(fc, 2, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
+				appendItems(fc, b2);
+				appendList(foundComb, fc);
+			}
+		}
+
+		//b2[0] = b1[1];
+		b2[1] = b1[3];
+		//b2[2] = '\0';
+
+		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 2) == 2) 
+		{
+			found++; 
+
+			if (foundComb == NULL) {
+				break;
+			} else {
+				fc = createListX(fc, 2, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
+				appendItems(fc, b2);
+				appendList(foundComb, fc);
+			}
+		}
+
+		//b2[0] = b1[1];
+		b2[1] = b1[4];
+		//b2[2] = '\0';
+
+		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 2) == 2) 
+		{
+			found++; 
+
+			if (foundComb == NULL) {
+				break;
+			} else {
+				fc = createListX(fc, 2, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
+				appendItems(fc, b2);
+				appendList(foundComb, fc);
+			}
+		}
+
+
+		b2[0] = b1[2];
+		b2[1] = b1[3];
+		//b2[2] = '\0';
+
+		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 2) == 2) 
+		{
+			found++; 
+
+			if (foundComb == NULL) {
+				break;
+			} else {
+				fc = createListX(fc, 2, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
+				appendItems(fc, b2);
+				appendList(foundComb, fc);
+			}
+		}
+
+		//b2[0] = b1[2];
+		b2[1] = b1[4];
+		//b2[2] = '\0';
+
+		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 2) == 2) 
+		{
+			found++; 
+
+			if (foundComb == NULL) {
+				break;
+			} else {
+				fc = createListX(fc, 2, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
+				appendItems(fc, b2);
+				appendList(foundComb, fc);
+			}
+		}
+
+
+		b2[0] = b1[3];
+		//b2[1] = b1[4];
+		//b2[2] = '\0';
+
+		if (aPrvDrawn->balls[0] <= b2[0] && seqSearchX(aPrvDrawn, b2, 2) == 2) 
+		{
+			found++; 
+
+			if (foundComb == NULL) {
+				break;
+			} else {
+				fc = createListX(fc, 2, NULL, aPrvDrawn->val, aPrvDrawn->val2, aPrvDrawn->year, aPrvDrawn->mon, aPrvDrawn->day);
+				appendItems(fc, b2);
+				appendList(foundComb, fc);
+			}
+		}
+
+		aPrvDrawn = aPrvDrawn->next;
+	}
+
+	return found;
+}
+
+
+
+UINT8 search2CombX(struct ListX *aPrvDrawn, struct ListX *drawnBalls, struct ListXY *luckyBalls, char *buf)
+{
+	return searchCombX(aPrvDrawn, drawnBalls, luckyBalls, buf, 2);
+}
+
+
+
+UINT8 searchCombX(struct ListX *aPrvDrawn, struct ListX *drawnBalls, struct ListXY *luckyBalls, char *buf, UINT8 comb)
+{
+	MASKWORD mask[MASK_WORDS];
+	UINT8 common[DRAW_BALL+1];
+	UINT8 balls[DRAW_BALL+1];
+	UINT8 pos[DRAW_BALL+1];
+	UINT8 i, n, bit;
+	UINT8 found = 0;
+
+	if (buf) buf[0] = '\0';
+
+	setMaskX(mask, aPrvDrawn->balls, aPrvDrawn->index);
+
+	for (i=0, n=0; i<drawnBalls->index && n<DRAW_BALL; i++) 
+	{
+		if (drawnBalls->balls[i] == 0 || drawnBalls->balls[i] > MASK_WORDS*MASK_BITS) continue;
+
+		bit = drawnBalls->balls[i] - 1;
+		if (mask[bit / MASK_BITS] & ((MASKWORD) 1 << (bit % MASK_BITS))) common[n++] = drawnBalls->balls[i];
+	}
+
+	if (comb == 0 || n < comb) return 0;
+
+	if (buf == NULL && luckyBalls == NULL) return (UINT8) combCount(n, comb);
+
+	/* common balls keep the order of drawnBalls, so the combinations are enumerated in lexicographic order */
+
+	for (i=0; i<comb; i++) {
+		pos[i] = i;
+	}
+
+	while (1)
+	{
+		for (i=0; i<comb; i++) {
+			balls[i] = common[pos[i]];
+		}
+		balls[comb] = '\0';
+
+		foundComb(aPrvDrawn, drawnBalls, luckyBalls, buf, balls, comb, found);
+		found++;
+
+		for (i=comb; i>0 && pos[i-1] == n-comb+i-1; i--);
+
+		if (i == 0) break;
+
+		pos[i-1]++;
+
+		for (; i<comb; i++) {
+			pos[i] = pos[i-1] + 1;
+		}
+	}
+
+	return found;
+}
+
+
+
+UINT32 combCount(UINT8 n, UINT8 k)
+{
+	UINT32 c = 1;
+	UINT8 i;
+
+	if (k > n) return 0;
+
+	for (i=1; i<=k; i++) {
+		c = c * (n-k+i) / i;
+	}
+
+	return c;
+}
+
+
+
+struct CouponIndex *createCouponIndex(struct CouponIndex *pi, UINT8 totalBall, UINT8 drawBallCount)
+{
+	UINT32 words;
+	UINT8 k;
+
+	pi = (struct CouponIndex *) malloc(sizeof(struct CouponIndex));
+
+	if (pi == NULL) return NULL;
+
+	pi->rows = 0;
+	pi->totalBall = totalBall;
+	pi->maxComb = drawBallCount < 4 ? drawBallCount : 4;
+
+	for (k=0; k<5; k++) {
+		pi->bits[k] = NULL;
+	}
+
+	for (k=1; k<=pi->maxComb; k++) 
+	{
+		words = (combCount(totalBall, k) + MASK_BITS - 1) / MASK_BITS;
+
+		if ((pi->bits[k] = (MASKWORD *) calloc(words, sizeof(MASKWORD))) == NULL) {
+			removeCouponIndex(pi);
+			return NULL;
+		}
+	}
+
+	return pi;
+}
+
+
+
+UINT8 probeCouponIndex(struct CouponIndex *pi, struct ListX *drawnBalls, UINT8 comb, UINT8 add)
+{
+	UINT8 balls[DRAW_BALL+1];
+	UINT8 keys[DRAW_BALL+1];
+	UINT8 pos[DRAW_BALL+1];
+	UINT8 i, j, n, tmp;
+	UINT32 rank;
+	MASKWORD bit;
+
+	n = drawnBalls->index < DRAW_BALL ? drawnBalls->index : DRAW_BALL;
+
+	if (comb == 0 || comb > pi->maxComb || comb > n) return 0;
+
+	for (i=0; i<n; i++) {
+		balls[i] = drawnBalls->balls[i];
+	}
+
+	for (i=1; i<n; i++) {
+		for (j=i; j>0 && balls[j-1] > balls[j]; j--) {
+			tmp = balls[j];
+			balls[j] = balls[j-1];
+			balls[j-1] = tmp;
+		}
+	}
+
+	for (i=0; i<comb; i++) {
+		pos[i] = i;
+	}
+
+	while (1)
+	{
+		for (i=0; i<comb; i++) {
+			keys[i] = balls[pos[i]];
+		}
+
+		rank = combRank(keys, comb);
+		bit = (MASKWORD) 1 << (rank % MASK_BITS);
+
+		if (add) pi->bits[comb][rank / MASK_BITS] |= bit;
+		else if (pi->bits[comb][rank / MASK_BITS] & bit) return 1;
+
+		for (i=comb; i>0 && pos[i-1] == n-comb+i-1; i--);
+
+		if (i == 0) break;
+
+		pos[i-1]++;
+
+		for (; i<comb; i++) {
+			pos[i] = pos[i-1] + 1;
+		}
+	}
+
+	return 0;
+}
+
+
+
+void removeCouponIndex(struct CouponIndex *pi)
+{
+	UINT8 k;
+
+	for (k=0; k<5; k++) {
+		if (pi->bits[k]) free(pi->bits[k]);
+	}
+
+	free(pi);
+}
+
+
+
+void clearCouponIndex(struct CouponIndex *pi)
+{
+	UINT32 words;
+	UINT8 k;
+
+	if (pi == NULL) return;
+
+	for (k=1; k<=pi->maxComb; k++) {
+		words = (combCount(pi->totalBall, k) + MASK_BITS - 1) / MASK_BITS;
+		memset(pi->bits[k], 0, words*sizeof(MASKWORD));
+	}
+
+	pi->rows = 0;
+}
+
+
+
+UINT8 searchCoupon(struct ListXY *coupon, struct ListX *drawnBalls, UINT8 drawBallCount, UINT8 comb)
+{
+	if (coupon->couponIndex) {
+		return probeCouponIndex(coupon->couponIndex, drawnBalls, comb, 0);
+	}
+
+	switch (comb)
+	{
+	case 1 : return search1BallXY(coupon, drawnBalls, drawBallCount);
+	case 2 : return search2CombXY(coupon, drawnBalls, NULL);
+	case 3 : return search3CombXY(coupon, drawnBalls, NULL);
+	default: return search4CombXY(coupon, drawnBalls, NULL);
+	}
+}
+
+
+
+UINT32 couponRows(struct ListXY *coupon)
+{
+	if (coupon->couponIndex) return coupon->couponIndex->rows;
+
+	return lengthY(coupon);
+}
+
+
+
+struct LuckyIndex *createLuckyIndex(struct LuckyIndex *pi, struct ListXY *luckyBalls, UINT8 comb, UINT8 totalBall)
+{
+	struct ListX *nl;
+	struct LuckyComb *lc;
+	UINT32 i, rows;
+
+	if (luckyBalls == NULL) return NULL;
+
+	pi = (struct LuckyIndex *) malloc(sizeof(struct LuckyIndex));
+
+	if (pi == NULL) return NULL;
+
+	pi->comb = comb;
+
+	/* counted here, the list can hold more combinations than a 16 bit row number */
+	for (rows=0, nl=luckyBalls->list; nl; nl=nl->next) {
+		if (nl->index == comb && nl->val) rows++;
+	}
+
+	if (comb <= 2) {
+		pi->dense = 1;
+		pi->size = combCount(totalBall, 2);
+	} else {
+		pi->dense = 0;
+		for (pi->size = 64; pi->size < rows*2; pi->size *= 2);
+	}
+
+	if ((pi->items = (struct LuckyComb *) malloc(sizeof(struct LuckyComb)*pi->size)) == NULL) {
+		free(pi);
+		return NULL;
+	}
+
+	for (i=0; i<pi->size; i++) {
+		pi->items[i].val = 0;
+	}
+
+	for (nl=luckyBalls->list; nl; nl=nl->next)
+	{
+		if (nl->index != comb || nl->val == 0) continue;
+
+		if ((lc = getLuckyComb(pi, nl->balls, 1)) != NULL) {
+			lc->epochDay = nl->epochDay;
+			lc->val = nl->val;
+			lc->val2 = nl->val2;
+		}
+	}
+
+	return pi;
+}
+
+
+
+void removeLuckyIndex(struct LuckyIndex *pi)
+{
+	if (pi == NULL) return;
+
+	free(pi->items);
+	free(pi);
+}
+
+
+
+struct LuckyComb *getLuckyComb(struct LuckyIndex *pi, UINT8 *balls, UINT8 add)
+{
+	return getLuckyRank(pi, combRank(balls, pi->comb), add);
+}
+
+
+
+struct LuckyComb *getLuckyRank(struct LuckyIndex *pi, UINT32 rank, UINT8 add)
+{
+	UINT32 slot;
+
+	if (pi->dense) {
+		if (rank >= pi->size) return NULL;
+		slot = rank;
+	} else {
+		slot = rank ^ (rank >> 16);
+		slot *= 0x45d9f3bUL;
+		slot ^= slot >> 16;
+		slot &= pi->size-1;
+
+		while (pi->items[slot].val && pi->items[slot].rank != rank) {
+			slot = (slot+1) & (pi->size-1);
+		}
+	}
+
+	if (pi->items[slot].val == 0) {
+		if (!add) return NULL;
+		pi->items[slot].rank = rank;
+	}
+
+	return &pi->items[slot];
+}
+
+
+
+UINT8 searchLucky(struct ListX *drawnBalls, UINT8 comb, UINT8 *due)
+{
+	struct LuckyIndex *pi = luckyIndex[comb];
+	struct LuckyComb *lc;
+	struct ListXY *combList = NULL;
+	struct ListX *fc;
+	UINT8 keys[DRAW_BALL+1];
+	UINT8 pos[DRAW_BALL+1];
+	UINT8 i, n;
+	UINT8 found = 0;
+	UINTDAY dDiff;
+
+	if (due != NULL) *due = 0;
+
+	if (pi == NULL)
+	{
+		/* the lucky rows are compared one by one */
+		if (due != NULL) combList = createListXY(combList);
+
+		switch (comb)
+		{
+		case 2 : found = search2CombXY(luckyBalls2, drawnBalls, combList); break;
+		case 3 : found = search3CombXY(luckyBalls3, drawnBalls, combList); break;
+		default: found = search4CombXY(luckyBalls4, drawnBalls, combList); break;
+		}
+
+		if (combList == NULL) return found;
+
+		for (fc=combList->list; fc; fc=fc->next)
+		{
+			dDiff = currEpochDay - fc->epochDay;
+
+			if (dDiff >= fc->val2 && ((double) fc->val * (double) fc->val2 / (double) drawnDays) >= 0.49) {
+				*due = 1;
+				break;
+			}
+		}
+
+		removeAllXY(combList);
+		free(combList);
+
+		return found;
+	}
+
+	n = drawnBalls->index < DRAW_BALL ? drawnBalls->index : DRAW_BALL;
+
+	if (comb > n) return 0;
+
+	for (i=0; i<comb; i++) {
+		pos[i] = i;
+	}
+
+	/* 
+	 * The balls are taken in the drawn order. A lucky row is matched ball by ball (seqSearchX),
+	 * so a combination is only found if its balls are in ascending order in the drawn balls.
+	 */
+	while (1)
+	{
+		for (i=0; i<comb; i++) {
+			keys[i] = drawnBalls->balls[pos[i]];
+		}
+
+		for (i=1; i<comb && keys[i-1] < keys[i]; i++);
+
+		if (i == comb && (lc = getLuckyComb(pi, keys, 0)) != NULL)
+		{
+			found++;
+
+			if (due == NULL) return found;
+
+			dDiff = currEpochDay - lc->epochDay;
+
+			if (dDiff >= lc->val2 && ((double) lc->val * (double) lc->val2 / (double) drawnDays) >= 0.49) {
+				*due = 1;
+			}
+		}
+
+		for (i=comb; i>0 && pos[i-1] == n-comb+i-1; i--);
+
+		if (i == 0) break;
+
+		pos[i-1]++;
+
+		for (; i<comb; i++) {
+			pos[i] = pos[i-1] + 1;
+		}
+	}
+
+	return found;
+}
+
+
+
+UINT8 elimByLucky(struct ListX *drawnBalls, UINT8 elimComb)
+{
+	UINT8 comb, due;
+
+	if (elimComb > 4) return 0;
+
+	for (comb=elimComb; comb>=2; comb--) {
+		if (searchLucky(drawnBalls, comb, &due)) return !due;
+	}
+
+	return 0;
+}
+
+
+
+struct LuckyPartners *createLuckyPartners(struct LuckyPartners *lp, struct ListXY *luckyBalls, UINT8 comb, UINT8 totalBall)
+{
+	struct ListX **rows = NULL;
+	struct ListX *nl;
+	UINTROW minVal, maxVal;
+	UINT32 i, n, k;
+	UINT8 j, ball;
+
+	if (luckyBalls == NULL) return NULL;
+
+	/* counted here, the list can hold more combinations than a 16 bit row number */
+	for (n=0, nl=luckyBalls->list; nl; nl=nl->next) {
+		if (nl->index == comb) n++;
+	}
+
+	if (n == 0) return NULL;
+
+	if ((rows = (struct ListX **) malloc(sizeof(struct ListX *)*n)) == NULL) return NULL;
+
+	for (i=0, nl=luckyBalls->list; nl && i<n; nl=nl->next) {
+		if (nl->index == comb) rows[i++] = nl;
+	}
+
+	n = i;
+
+	lp = (struct LuckyPartners *) malloc(sizeof(struct LuckyPartners));
+
+	if (n == 0 || lp == NULL) {
+		free(rows);
+		if (lp) free(lp);
+		return NULL;
+	}
+
+	lp->comb = comb;
+	lp->rows = n;
+	lp->balls = (UINT8 *) malloc((UINT32) n*comb);
+	lp->first = (UINT32 *) calloc(totalBall+2, sizeof(UINT32));
+	lp->partners = NULL;
+
+	if (lp->balls == NULL || lp->first == NULL) {
+		free(rows);
+		removeLuckyPartners(lp);
+		return NULL;
+	}
+
+	/* the order drawBallsByLucky had sorted the list in (by days apart and then by count) */
+	qsort(rows, n, sizeof(struct ListX *), compareLuckyRows);
+
+	for (i=0; i<n; i++) {
+		for (j=0; j<comb; j++) {
+			lp->balls[(UINT32) i*comb + j] = rows[i]->balls[j];
+		}
+	}
+
+	minVal = rows[n-1]->val;
+	maxVal = rows[0]->val;
+
+	for (lp->top=0; lp->top < (UINT32) ceil(2*n/3) && rows[lp->top]->val > (UINTROW) ceil((minVal+maxVal)/2); lp->top++);
+
+	if (lp->top < 10) lp->top = n;
+
+	free(rows);
+
+	/* a ball is paired with the first other ball of the row */
+	for (i=0; i<lp->top; i++) {
+		for (j=0; j<comb; j++) {
+			lp->first[lp->balls[(UINT32) i*comb + j] + 1]++;
+		}
+	}
+
+	for (k=1; k<(UINT32) totalBall+2; k++) {
+		lp->first[k] += lp->first[k-1];
+	}
+
+	if ((lp->partners = (UINT8 *) malloc(lp->first[totalBall+1] + 1)) == NULL) {
+		removeLuckyPartners(lp);
+		return NULL;
+	}
+
+	for (i=0; i<lp->top; i++) 
+	{
+		for (j=0; j<comb; j++) {
+			ball = lp->balls[(UINT32) i*comb + j];
+			lp->partners[lp->first[ball]++] = lp->balls[(UINT32) i*comb + (j == 0 ? 1 : 0)];
+		}
+	}
+
+	for (k=(UINT32) totalBall+1; k>0; k--) {
+		lp->first[k] = lp->first[k-1];
+	}
+
+	lp->first[0] = 0;
+
+	return lp;
+}
+
+
+
+void removeLuckyPartners(struct LuckyPartners *lp)
+{
+	if (lp == NULL) return;
+
+	if (lp->balls) free(lp->balls);
+	if (lp->partners) free(lp->partners);
+	if (lp->first) free(lp->first);
+	free(lp);
+}
+
+
+
+int compareLuckyRows(const void *p1, const void *p2)
+{
+	struct ListX *l1 = *(struct ListX **) p1;
+	struct ListX *l2 = *(struct ListX **) p2;
+	UINT8 i;
+
+	if (l1->val2 != l2->val2) return l1->val2 > l2->val2 ? -1 : 1;
+	if (l1->val != l2->val) return l1->val > l2->val ? -1 : 1;
+
+	for (i=0; i<l1->index && i<l2->index; i++) {
+		if (l1->balls[i] != l2->balls[i]) return l1->balls[i] < l2->balls[i] ? -1 : 1;
+	}
+
+	return 0;
+}
+
+
+
+
+UINT8 search1BallXY(struct ListXY *couponList, struct ListX *drawnBalls, UINT8 drawBallCount)
+{
+	UINT16 i, listRows;
+	UINT8 j;
+	struct ListX *aPrvDrawn = NULL;
+	UINT8 balls[DRAW_BALL+1];
+	UINT8 found = 0;
+
+	listRows = lengthY(couponList);
+
+	getKeys(drawnBalls, balls, 0, drawBallCount);
+
+	aPrvDrawn = couponList->list;
+
+	for (i=0; aPrvDrawn && i<listRows; i++) 
+	{
+		for (j=0; j<drawBallCount; j++) 
+		{
+			if (aPrvDrawn->balls[0] <= balls[j] && seqSearchX1(aPrvDrawn, balls[j]) >= 0) {
+				found=1; 
+				break;
+			}
+		}
+
+		if (found) break;
+
+		aPrvDrawn = aPrvDrawn->next;
+	}
+
+	return found;
+}
+
+
+
+void foundComb(struct ListX *aPrvDrawn, struct ListX *drawnBalls, struct ListXY *luckyBalls, char *buf, UINT8 *balls, UINT8 comb, UINT8 foundPrev)
+{
+	struct ListX *lb = NULL;
+	int index;
+	char fStr[20];
+	UINTDAY dDiff;
+
+	if (buf) 
+	{
+		if (foundPrev) strcat(buf, ", ");
+
+		switch (comb)
+		{
+		case 2 : sprintf(fStr, "(%2d,%2d)", balls[0], balls[1]);
+		break;
+		case 3 : sprintf(fStr, "(%2d,%2d,%2d)", balls[0], balls[1], balls[2]);
+		break;
+		case 4 : sprintf(fStr, "(%2d,%2d,%2d,%2d)", balls[0], balls[1], balls[2], balls[3]);
+		break;
+		case 5 : sprintf(fStr, "(%2d,%2d,%2d,%2d,%2d)", balls[0], balls[1], balls[2], balls[3], balls[4]);
+		break;
+		default: break;
+		}
+
+		strcat(buf, fStr);
+	}
+
+	if (luckyBalls) 
+	{
+		if ((index = seqSearchXY(luckyBalls, balls, comb)) < 0) {
+			dDiff = drawnBalls->epochDay - aPrvDrawn->epochDay;
+			lb = createListX(lb, comb, NULL, 1, dDiff, drawnBalls->year, drawnBalls->mon, drawnBalls->day);
+			appendItems(lb, balls);
+			appendList(luckyBalls, lb);
+		} else {
+			lb = getListXByIndex(luckyBalls, index);
+			dDiff = lb->epochDay - aPrvDrawn->epochDay;
+			lb->val2 = (UINTDAY) ceil(dDiff / numberOfTerm(lb->val));
+			lb->val++;
+		}
+	}
+}
+
+
+
+UINT8 init()
+{
+	time_t rawtime;
+	struct tm *timeInfo;
+
+	struct ListX *tmp = NULL;
+	struct ListX *tmp2 = NULL;
+	struct ListX oldestDrawn, latestDrawn;
+	int err;
+	UINT8 snapshot = 0;
+	char realPath[PATH_MAX];
+	cwd = (char *) malloc(sizeof(char)*PATH_MAX);
+	fileStats = (char *) malloc(sizeof(char)*PATH_MAX);
+	outputFile = (char *) malloc(sizeof(char)*PATH_MAX);
+
+	time(&rawtime);
+	timeInfo = localtime(&rawtime);
+
+	fileStats[0] = '\0';
+	outputFile[0] = '\0';
+
+#if defined(__linux__) || defined(__unix__) || defined(__APPLE__) || defined(SOLARIS) || defined(WIN32)
+	err = get_app_path(realPath, PATH_MAX);
+	if (err) {
+		puts("App path lookup failed!");
+		return 0;
+	}
+	else {
+		cwd = dirname(realPath);
+
+		strcat(fileStats, cwd);
+		strcat(fileStats, PATH_SEPARATOR);
+		strcat(outputFile, cwd);
+		strcat(outputFile, PATH_SEPARATOR);
+	}
+#endif
+
+	strcat(fileStats, FILESTATS);
+	strcat(outputFile, OUTPUTFILE);
+
+	if (showProgress) puts("Initializing... Please wait.");
+
+	winningDrawnBallsList = createTableXY(winningDrawnBallsList, DRAW_BALL, 512);
+	plusNumberDrawnBallsList = createTableXY(plusNumberDrawnBallsList, 1, 512);
+	luckyBalls2 = createListXY(luckyBalls2);
+	luckyBalls3 = createListXY(luckyBalls3);
+	luckyBalls4 = createListXY(luckyBalls4);
+	winningBallsDrawCount = createListX2(winningBallsDrawCount, TOTAL_BALL);
+	plusNumberBallsDrawCount = createListX2(plusNumberBallsDrawCount, TOTAL_BALL_PN);
+
+	#ifdef USE_SNAPSHOT
+	snapshot = loadSnapshot(fileStats);
+	#endif
+
+	#if defined(__MSDOS__)
+	/* the plus numbers are read after the lucky balls due to lack of memory */
+	winningBallRows = getDrawnBallsList(winningDrawnBallsList, NULL, fileStats);
+	#else
+	if (!snapshot) {
+		winningBallRows = getDrawnBallsList(winningDrawnBallsList, plusNumberDrawnBallsList, fileStats);
+		pNumberBallRows = plusNumberDrawnBallsList->rows;
+	}
+	#endif
+
+	if (!winningBallRows) {
+		printf("%s file or record not found!\n", fileStats);
+		return 0;
+	}
+
+	#ifndef __MSDOS__
+	if (!pNumberBallRows) {
+		printf("%s file or record not found!\n", fileStats);
+		return 0;
+	}
+	#endif
+
+	tmp = getListXByRow(winningDrawnBallsList, winningBallRows-1, &oldestDrawn);
+	formatDate(dateStart, tmp->day, tmp->mon, tmp->year);
+	tmp2 = getListXByRow(winningDrawnBallsList, 0, &latestDrawn);
+	formatDate(dateEnd, tmp2->day, tmp2->mon, tmp2->year);
+
+	drawnDays = tmp2->epochDay - tmp->epochDay;
+
+	windowFirst = 0;
+	windowLast = winningBallRows-1;
+
+	currDay = (UINT8) timeInfo->tm_mday;
+	currMon = (UINT8) timeInfo->tm_mon +1;
+	currYear = (UINT16) timeInfo->tm_year +1900;
+	currEpochDay = getEpochDay(currDay, currMon, currYear);
+
+	if (!snapshot) {
+		if ((luckyBalls2 = getLuckyBalls(luckyBalls2, 2)) == NULL) {
+			puts("There is not enough memory for the lucky numbers!");
+			return 0;
+		}
+		bubbleSortYByVal(luckyBalls2, -1);
+	}
+
+	#if defined(__MSDOS__)
+	removeAllT(winningDrawnBallsList);
+	if (!saveLuckyBallsToFile(luckyBalls2, 2)) return 0;
+	removeAllXY(luckyBalls2);
+	if (!(winningBallRows = getDrawnBallsList(winningDrawnBallsList, NULL, fileStats))) {
+		printf("%s file or record not found!\n", fileStats);
+		return 0;
+	}
+	#endif
+
+	if (!snapshot) {
+		if ((luckyBalls3 = getLuckyBalls(luckyBalls3, 3)) == NULL) {
+			puts("There is not enough memory for the lucky numbers!");
+			return 0;
+		}
+		bubbleSortYByVal(luckyBalls3, -1);
+	}
+
+	#if defined(__MSDOS__)
+	removeAllT(winningDrawnBallsList);
+	if (!saveLuckyBallsToFile(luckyBalls3, 3)) return 0;
+	removeAllXY(luckyBalls3);
+	if (!(winningBallRows = getDrawnBallsList(winningDrawnBallsList, NULL, fileStats))) {
+		printf("%s file or record not found!\n", fileStats);
+		return 0;
+	}
+	#endif
+
+	if (!snapshot) {
+		if ((luckyBalls4 = getLuckyBalls(luckyBalls4, 4)) == NULL) {
+			puts("There is not enough memory for the lucky numbers!");
+			return 0;
+		}
+		bubbleSortYByVal(luckyBalls4, -1);
+	}
+
+	#if defined(__MSDOS__)
+	removeAllT(winningDrawnBallsList);
+	if (!saveLuckyBallsToFile(luckyBalls4, 4)) return 0;
+	removeAllXY(luckyBalls4);
+	if (!(winningBallRows = getDrawnBallsList(winningDrawnBallsList, plusNumberDrawnBallsList, fileStats)) || !(pNumberBallRows = plusNumberDrawnBallsList->rows)) {
+		printf("%s file or record not found!\n", fileStats);
+		return 0;
+	}
+	#endif
+
+	if (!snapshot) 
+	{
+		getDrawnBallCount();
+
+		if (!calcMatchCombCount()) {
+			puts("There is not enough memory for the matching combinations!");
+			return 0;
+		}
+
+		#ifdef USE_SNAPSHOT
+		saveSnapshot(fileStats);
+		#endif
+	}
+
+	removeAllT(plusNumberDrawnBallsList);
+
+	if ((ballPostings = createBallPostings(ballPostings, winningDrawnBallsList, TOTAL_BALL)) == NULL) {
+		puts("There is not enough memory for the draws index!");
+		return 0;
+	}
+
+	#ifndef __MSDOS__
+	/* the lucky numbers are read from the swap files while drawing on MS-DOS */
+	luckyIndex[2] = createLuckyIndex(luckyIndex[2], luckyBalls2, 2, TOTAL_BALL);
+	luckyIndex[3] = createLuckyIndex(luckyIndex[3], luckyBalls3, 3, TOTAL_BALL);
+	luckyIndex[4] = createLuckyIndex(luckyIndex[4], luckyBalls4, 4, TOTAL_BALL);
+
+	luckyPartners2 = createLuckyPartners(luckyPartners2, luckyBalls2, 2, TOTAL_BALL);
+	luckyPartners3 = createLuckyPartners(luckyPartners3, luckyBalls3, 3, TOTAL_BALL);
+
+	prefixCounts = createPrefixCounts(prefixCounts, winningDrawnBallsList, TOTAL_BALL);
+	#endif
+
+	if (showProgress) clearScreen();
+
+	#ifdef __MSDOS__
+	free(cwd);
+	free(fileStats);
+	cwd = NULL;
+	fileStats = NULL;
+	#endif
+
+	return 1;
+}
+
+
+
+struct ListXY * getLuckyBalls(struct ListXY *luckyBalls, UINT8 comb)
+{
+	struct CombTable *combTable = NULL;
+
+	combTable = createCombTable(combTable, comb, TOTAL_BALL, (UINT32) winningBallRows*combCount(winningDrawnBallsList->cols, comb));
+
+	if (combTable == NULL) return NULL;
+
+	if (!countCombT(winningDrawnBallsList, combTable)) {
+		removeAllC(combTable);
+		free(combTable);
+		return NULL;
+	}
+
+	luckyBalls = getCombCountList(luckyBalls, combTable, winningDrawnBallsList);
+
+	removeAllC(combTable);
+	free(combTable);
+
+	return luckyBalls;
+}
+
+
+
+UINT8 setStatsWindow(UINTROW first, UINTROW last)
+{
+	struct TableXY *pt = winningDrawnBallsList;
+	struct PrefixCounts *pp = prefixCounts;
+	struct CombTable *combTable = NULL;
+	struct ListXY *luckyLists[5] = {NULL, NULL, NULL, NULL, NULL};
+	struct CombCount *cc;
+	UINTROW *row1, *row2;
+	UINTROW r, count;
+	UINT32 rank;
+	UINT8 balls[2];
+	UINT8 i, comb;
+
+	if (pp == NULL || last >= pp->rows || first > last) return 0;
+
+	/* draw counts of the balls */
+
+	row1 = pp->balls + (size_t) first*(TOTAL_BALL+1);
+	row2 = pp->balls + ((size_t) last+1)*(TOTAL_BALL+1);
+
+	removeAllX2(winningBallsDrawCount);
+
+	for (i=1; i <= TOTAL_BALL; i++) {
+		appendItem2(winningBallsDrawCount, i, row2[i] - row1[i]);
+	}
+
+	/* lucky numbers */
+
+	luckyLists[2] = luckyBalls2;
+	luckyLists[3] = luckyBalls3;
+	luckyLists[4] = luckyBalls4;
+
+	for (comb=2; comb<=4; comb++)
+	{
+		combTable = createCombTable(combTable, comb, TOTAL_BALL, (UINT32) (last-first+1)*combCount(pt->cols, comb));
+
+		if (combTable == NULL) return 0;
+
+		if (comb == 2 && pp->pairs) 
+		{
+			row1 = pp->pairs + (size_t) first*pp->pairCount;
+			row2 = pp->pairs + ((size_t) last+1)*pp->pairCount;
+
+			for (balls[1]=2; balls[1] <= TOTAL_BALL; balls[1]++) 
+			{
+				for (balls[0]=1; balls[0] < balls[1]; balls[0]++) 
+				{
+					rank = combRank(balls, 2);
+
+					if ((count = row2[rank] - row1[rank]) == 0) continue;
+
+					cc = getCombCount(combTable, balls);
+					cc->count = count;
+					cc->first = getPrefixRow(pp, rank, first, last, 1);
+					cc->second = count > 1 ? getPrefixRow(pp, rank, first, last, 2) : cc->first;
+					cc->last = getPrefixRow(pp, rank, first, last, count);
+				}
+			}
+		}
+		else 
+		{
+			for (r=last; ; r--) 
+			{
+				if (!countCombRowT(pt, combTable, r)) {
+					removeAllC(combTable);
+					free(combTable);
+					return 0;
+				}
+
+				if (r == first) break;
+			}
+		}
+
+		removeAllXY(luckyLists[comb]);
+		getCombCountList(luckyLists[comb], combTable, pt);
+		bubbleSortYByVal(luckyLists[comb], -1);
+
+		removeAllC(combTable);
+		free(combTable);
+		combTable = NULL;
+
+		removeLuckyIndex(luckyIndex[comb]);
+		luckyIndex[comb] = createLuckyIndex(luckyIndex[comb], luckyLists[comb], comb, TOTAL_BALL);
+	}
+
+	removeLuckyPartners(luckyPartners2);
+	removeLuckyPartners(luckyPartners3);
+
+	luckyPartners2 = createLuckyPartners(luckyPartners2, luckyBalls2, 2, TOTAL_BALL);
+	luckyPartners3 = createLuckyPartners(luckyPartners3, luckyBalls3, 3, TOTAL_BALL);
+
+	/* dates of the window */
+
+	formatDate(dateStart, pt->day[last], pt->mon[last], pt->year[last]);
+	formatDate(dateEnd, pt->day[first], pt->mon[first], pt->year[first]);
+
+	drawnDays = pt->epochDay[first] - pt->epochDay[last];
+
+	windowFirst = first;
+	windowLast = last;
+
+	return 1;
+}
+
+
+
+UINT8 getWindowRows(char *window, UINTROW *first, UINTROW *last)
+{
+	struct TableXY *pt = winningDrawnBallsList;
+	unsigned long year1, year2, tmp;
+	char *endptr;
+	UINTROW r;
+
+	if (pt->rows == 0) return 0;
+
+	if (isIntString(window)) 
+	{
+		/* the latest draws */
+		tmp = strtoul(window, NULL, 10);
+		if (tmp == 0) return 0;
+
+		*first = 0;
+		*last = (tmp > pt->rows) ? pt->rows-1 : (UINTROW) (tmp-1);
+
+		return 1;
+	}
+
+	/* the draws of the years */
+
+	year1 = strtoul(window, &endptr, 10);
+	if (endptr == window || *endptr != '-') return 0;
+
+	window = endptr+1;
+	year2 = strtoul(window, &endptr, 10);
+	if (endptr == window || *endptr != '\0') return 0;
+
+	if (year1 > year2) {
+		tmp = year1;
+		year1 = year2;
+		year2 = tmp;
+	}
+
+	for (r=0; r < pt->rows && pt->year[r] > year2; r++);
+
+	if (r == pt->rows || pt->year[r] < year1) return 0;
+
+	*first = r;
+
+	for (; r < pt->rows && pt->year[r] >= year1; r++);
+
+	*last = r-1;
+
+	return 1;
+}
+
+
+
+UINT8 saveLuckyBallsToFile(struct ListXY *luckyBalls, UINT8 comb)
+{
+	struct ListX *nl = NULL;
+	char lbFile[14];
+	char ioBuf[20];
+	char buf[5];
+	UINT8 i;
+	FILE *fp;
+
+	switch (comb)
+	{
+	case 2 : strcpy(lbFile, LBL2SWAPFILE); break;
+	case 3 : strcpy(lbFile, LBL3SWAPFILE); break;
+	case 4 : strcpy(lbFile, LBL4SWAPFILE); break;
+	default: break;
+	}
+
+	if ((fp = fopen(lbFile, "w")) == NULL) {
+		printf("Can't open file %s\n", lbFile);
+		pressAnyKeyToExit();
+		return 0;
+	}
+
+	if (luckyBalls == NULL || luckyBalls->list == NULL) {
+		return 0;
+	}
+
+	nl = luckyBalls->list;
+
+	while (nl)
+	{
+		ioBuf[0] = '\0';
+
+		for (i=0; i < nl->index; i++) {
+			sprintf(buf, "%02d", nl->balls[i]);
+			strcat(ioBuf, buf);
+		}
+
+		sprintf(buf, "%d\n", nl->val);
+		strcat(ioBuf, buf);
+
+		nl = nl->next;
+
+		fputs(ioBuf, fp);
+	}
+
+	fclose(fp);
+
+	return 1;
+}
+
+
+
+struct ListXY * getLuckyBallsFromFile(struct ListXY *luckyBalls, UINT8 comb)
+{
+	UINT16 i;
+	UINT8 j, k;
+	int n1, n2, n3, n4, val;
+	//UINT8 keys[DRAW_BALL+1];
+	char lbFile[14];
+	char ioBuf[20];
+	char s[6];
+
+	FILE *fp;
+
+	struct ListX *drawList = NULL;
+
+	switch (comb)
+	{
+	case 2 : strcpy(lbFile, LBL2SWAPFILE); break;
+	case 3 : strcpy(lbFile, LBL3SWAPFILE); break;
+	case 4 : strcpy(lbFile, LBL4SWAPFILE); break;
+	default: break;
+	}
+
+	if ((fp = fopen(lbFile, "r")) == NULL) {
+		printf("Can't open file %s\n", lbFile);
+		pressAnyKeyToExit();
+		return NULL;
+	}
+
+	for (i=0; fgets(ioBuf, 20, fp) && i<UINT16MAX; i++)
+	{
+		drawList = createListX(drawList, comb, NULL, 0, 0, 0, 0, 0);
+
+		if (comb == 2) 
+		{
+			s[0] = ioBuf[0];
+			s[1] = ioBuf[1];
+			s[2] = '\0';
+			n1 = atoi(s);
+
+			s[0] = ioBuf[2];
+			s[1] = ioBuf[3];
+			s[2] = '\0';
+			n2 = atoi(s);
+
+			for (j=0, k=4; !(ioBuf[k]=='\n'||ioBuf[k]=='\0'); j++, k++){
+				s[j] = ioBuf[k];
+			}
+			s[j] = '\0';
+			val = atoi(s);
+/*			
+			keys[0] = (UINT8) n1;
+			keys[1] = (UINT8) n2;
+			keys[2] = '\0';
+*/
+			drawList->balls[0] = (UINT8) n1;
+			drawList->balls[1] = (UINT8) n2;
+			drawList->index += 2;
+		}
+		else if (comb == 3) 
+		{
+			s[0] = ioBuf[0];
+			s[1] = ioBuf[1];
+			s[2] = '\0';
+			n1 = atoi(s);
+
+			s[0] = ioBuf[2];
+			s[1] = ioBuf[3];
+			s[2] = '\0';
+			n2 = atoi(s);
+
+			s[0] = ioBuf[4];
+			s[1] = ioBuf[5];
+			s[2] = '\0';
+			n3 = atoi(s);
+
+			for (j=0, k=6; !(ioBuf[k]=='\n'||ioBuf[k]=='\0'); j++, k++){
+				s[j] = ioBuf[k];
+			}
+			s[j] = '\0';
+			val = atoi(s);
+/*
+			keys[0] = (UINT8) n1;
+			keys[1] = (UINT8) n2;
+			keys[2] = (UINT8) n3;
+			keys[3] = '\0';
+*/
+			drawList->balls[0] = (UINT8) n1;
+			drawList->balls[1] = (UINT8) n2;
+			drawList->balls[2] = (UINT8) n3;
+			drawList->index += 3;
+		}
+		else if (comb == 4)
+		{
+			s[0] = ioBuf[0];
+			s[1] = ioBuf[1];
+			s[2] = '\0';
+			n1 = atoi(s);
+
+			s[0] = ioBuf[2];
+			s[1] = ioBuf[3];
+			s[2] = '\0';
+			n2 = atoi(s);
+
+			s[0] = ioBuf[4];
+			s[1] = ioBuf[5];
+			s[2] = '\0';
+			n3 = atoi(s);
+
+			s[0] = ioBuf[6];
+			s[1] = ioBuf[7];
+			s[2] = '\0';
+			n4 = atoi(s);
+
+			for (j=0, k=8; !(ioBuf[k]=='\n'||ioBuf[k]=='\0'); j++, k++){
+				s[j] = ioBuf[k];
+			}
+			s[j] = '\0';
+			val = atoi(s);
+/*
+			keys[0] = (UINT8) n1;
+			keys[1] = (UINT8) n2;
+			keys[2] = (UINT8) n3;
+			keys[3] = (UINT8) n4;
+			keys[4] = '\0';
+*/
+			drawList->balls[0] = (UINT8) n1;
+			drawList->balls[1] = (UINT8) n2;
+			drawList->balls[2] = (UINT8) n3;
+			drawList->balls[3] = (UINT8) n4;
+			drawList->index += 4;
+		}
+
+		drawList->val = (UINT16) val;
+		//appendItems(drawList, keys);
+		appendList(luckyBalls, drawList);
+	}
+
+	fclose(fp);
+
+	return luckyBalls;
+}
+
+
+
+UINT8 calcMatchCombCount()
+{
+	struct CombTable *combTable = NULL;
+	UINT32 i;
+	UINTSUM matchComb;
+	UINT8 comb;
+
+	/* a combination drawn f times matches in C(f,2) pairs of draws */
+
+	for (comb=2; comb<=DRAW_BALL; comb++)
+	{
+		combTable = createCombTable(combTable, comb, TOTAL_BALL, (UINT32) winningBallRows*combCount(DRAW_BALL, comb));
+
+		if (combTable == NULL) return 0;
+
+		if (!countCombT(winningDrawnBallsList, combTable)) {
+			removeAllC(combTable);
+			free(combTable);
+			return 0;
+		}
+
+		for (i=0, matchComb=0; i<combTable->size; i++) {
+			matchComb += (UINTSUM) combTable->items[i].count * (combTable->items[i].count-1) / 2;
+		}
+
+		switch (comb)
+		{
+		case 2 : match2comb += matchComb; break;
+		case 3 : match3comb += matchComb; break;
+		case 4 : match4comb += matchComb; break;
+		case 5 : match5comb += matchComb; break;
+		default: break;
+		}
+
+		removeAllC(combTable);
+		free(combTable);
+	}
+
+	return 1;
+}
+
+
+
+void calcMatchComb(UINT8 comb, FILE *fp)
+{
+	UINTROW i, j;
+	UINT32 k;
+	UINTSUM x;
+	UINT8 d1, m1;
+	UINT16 y1;
+	UINTDAY dDif;
+	UINTSUM matchComb;
+	UINT8 found;
+	struct ListX *aPrvDrawn1 = NULL;
+	struct ListX *aPrvDrawn2 = NULL;
+	struct ListX prvDrawn1, prvDrawn2;
+	MASKWORD *rowBits;
+	char lbBuf[119];
+	char pLabel[10];
+	char date1[11], date2[11];
+	char lastDate[11];
+
+	strcpy(pLabel, "Progress");
+
+	if ((rowBits = (MASKWORD *) malloc(sizeof(MASKWORD)*ballPostings->words)) == NULL) {
+		puts("There is not enough memory for the matched combinations!");
+		return;
+	}
+
+	if (comb >= 2 && comb <= 5) 
+	{
+		puts("Matched combinations of numbers from previous draws:\n");
+		if (fp != NULL) fprintf(fp, "Matched combinations of numbers from previous draws:\n\n");
+
+		switch (comb)
+		{
+		case 2 : matchComb = match2comb; break;
+		case 3 : matchComb = match3comb; break;
+		case 4 : matchComb = match4comb; break;
+		case 5 : matchComb = match5comb; break;
+		default: break;
+		}
+
+        printf("Matched %d combinations: %lu\n\n", comb, (unsigned long) matchComb);
+        if (fp != NULL) fprintf(fp, "Matched %d combinations: %lu\n\n", comb, (unsigned long) matchComb);
+
+		for (i=0, k=0, x=0; x<matchComb && i<winningBallRows; i++) 
+		{
+			if (comb >= 2 && comb <= 4) {
+					 printPercentOfProgress(pLabel, k, (UINT32) ceil((UINT32) winningBallRows*((UINT32) winningBallRows-1)/2));
+			}
+
+			aPrvDrawn1 = getListXByRow(winningDrawnBallsList, i, &prvDrawn1);
+
+			/* only the later draws that share a pair with the draw i can match it */
+			getPairRows(ballPostings, aPrvDrawn1->balls, aPrvDrawn1->index, i+1, rowBits);
+
+			k += winningBallRows-1-i;
+
+			for (j=nextDrawRow(ballPostings, rowBits, i+1); j<winningBallRows; j=nextDrawRow(ballPostings, rowBits, j+1)) 
+			{
+				if (overlapCountT(winningDrawnBallsList, i, j) < comb) continue;
+
+				aPrvDrawn2 = getListXByRow(winningDrawnBallsList, j, &prvDrawn2);
+
+				switch (comb)
+				{
+				case 2 : found = search2CombX(aPrvDrawn2, aPrvDrawn1, NULL, lbBuf); break;
+				case 3 : found = search3CombX(aPrvDrawn2, aPrvDrawn1, NULL, lbBuf); break;
+				case 4 : found = search4CombX(aPrvDrawn2, aPrvDrawn1, NULL, lbBuf); break;
+				case 5 : found = search5CombX(aPrvDrawn2, aPrvDrawn1); break;
+				default: break;
+				}
+
+				if (found) 
+				{
+					x++;
+
+					if (x == matchComb && comb < 5) printPercentOfProgress(pLabel, 1, 1);
+
+					formatDate(date1, aPrvDrawn1->day, aPrvDrawn1->mon, aPrvDrawn1->year);
+
+					if (strcmp(lastDate, date1) != 0) 
+					{
+						if (comb >= 5) {
+							puts("\n--------------------------------------------------------------------------------");
+							printf("\n%s : ", date1);
+						}
+
+						if (fp != NULL) {
+							fputs("\n--------------------------------------------------------------------------------", fp);
+							fprintf(fp, "\n%s : ", date1);
+						}
+
+						if (comb >= 5) printListXByKey(aPrvDrawn1, 0, fp);
+						else  printListXByKey(aPrvDrawn1, 2, fp);
+						
+						if (comb >= 5) printf("   ");
+						if (fp != NULL) fprintf(fp, "   ");
+						
+						y1 = aPrvDrawn1->year;
+						m1 = aPrvDrawn1->mon;
+						d1 = aPrvDrawn1->day;
+						formatDate(date1, d1, m1, y1);
+					}
+					else {
+						if (comb >= 5) printf("                               ");
+						if (fp != NULL) fprintf(fp, "                               ");
+					}
+					
+					formatDate(date2, aPrvDrawn2->day, aPrvDrawn2->mon, aPrvDrawn2->year);
+
+					if (comb >= 5) printf("    %s : ", date2);
+					if (fp != NULL) fprintf(fp, "    %s : ", date2);
+			
+					if (comb >= 5) printListXByKey(aPrvDrawn2, 0, fp);
+					else  printListXByKey(aPrvDrawn2, 2, fp);
+		
+					dDif = aPrvDrawn1->epochDay - aPrvDrawn2->epochDay;
+
+					if (comb >= 5) printf("   %4lu days", (unsigned long) dDif);
+					if (fp != NULL) fprintf(fp, "   %4lu days", (unsigned long) dDif);
+		
+					if (comb != 5) {
+						if (comb >= 5) printf("   %s", lbBuf);
+						if (fp != NULL) fprintf(fp, "   %s", lbBuf);
+					}
+
+					if (comb >= 5) puts("");
+					if (fp != NULL) fprintf(fp, "\n");
+					strcpy(lastDate, date1);
+				}
+			}
+		}
+
+		if (matchComb) {
+			if (comb >= 5) puts("\n--------------------------------------------------------------------------------\n");
+			if (fp != NULL) fputs("\n--------------------------------------------------------------------------------\n", fp);
+		}
+	}
+
+	free(rowBits);
+}
+
+
+
+void queryDraws(UINT8 *balls, UINT8 count, UINT8 printTo, FILE *fp)
+{
+	struct TableXY *pt = winningDrawnBallsList;
+	MASKWORD *rowBits;
+	UINTROW r, next, rows;
+	char ioBuf[80];
+	char buf[30];
+	UINT8 i;
+
+	if ((rowBits = (MASKWORD *) malloc(sizeof(MASKWORD)*ballPostings->words)) == NULL) {
+		puts("There is not enough memory for the query!");
+		return;
+	}
+
+	rows = getDrawRows(ballPostings, balls, count, rowBits);
+
+	strcpy(ioBuf, "Draws that contain the numbers");
+
+	for (i=0; i < count; i++) {
+		sprintf(buf, " %d", balls[i]);
+		strcat(ioBuf, buf);
+	}
+
+	sprintf(buf, ": %lu\n\n", (unsigned long) rows);
+	strcat(ioBuf, buf);
+
+	if (printTo == 0) printf("%s", ioBuf);
+	if (fp != NULL) fputs(ioBuf, fp);
+
+	/* rows are the latest draws first, the days are to the previous (older) draw of the numbers */
+
+	for (r=nextDrawRow(ballPostings, rowBits, 0); r < pt->rows; r=next)
+	{
+		next = nextDrawRow(ballPostings, rowBits, r+1);
+
+		formatDate(ioBuf, pt->day[r], pt->mon[r], pt->year[r]);
+		strcat(ioBuf, " : ");
+
+		for (i=0; i < pt->cols; i++) {
+			sprintf(buf, "%2d ", pt->balls[(UINT32) r*pt->cols + i]);
+			strcat(ioBuf, buf);
+		}
+
+		if (next < pt->rows) {
+			sprintf(buf, "  %4lu days", (unsigned long) (pt->epochDay[r] - pt->epochDay[next]));
+			strcat(ioBuf, buf);
+		}
+
+		strcat(ioBuf, "\n");
+
+		if (printTo == 0) printf("%s", ioBuf);
+		if (fp != NULL) fputs(ioBuf, fp);
+	}
+
+	free(rowBits);
+}
+
+
+
+UINT8 getQueryBalls(char *s, UINT8 *balls)
+{
+	int fields[DRAW_BALL+1];
+	char *pos = s;
+	UINT8 i, j, n, ball;
+
+	n = parseLine(&pos, s + strlen(s), fields, DRAW_BALL+1);
+
+	if (n == 0 || n > DRAW_BALL) return 0;
+
+	/* insertion sort of the numbers */
+
+	for (i=0; i < n; i++) 
+	{
+		if (fields[i] < 1 || fields[i] > TOTAL_BALL) return 0;
+
+		ball = (UINT8) fields[i];
+
+		for (j=i; j > 0 && balls[j-1] > ball; j--) {
+			balls[j] = balls[j-1];
+		}
+
+		if (j > 0 && balls[j-1] == ball) return 0;
+
+		balls[j] = ball;
+	}
+
+	return n;
+}
+
+
+
+void nearDuplicates(UINT32 days, UINT8 overlap, FILE *fp)
+{
+	struct TableXY *pt = winningDrawnBallsList;
+	MASKWORD *mask;
+	UINTROW i, j;
+	UINT32 x, pairs = 0, found = 0;
+	double tail[DRAW_BALL+2];
+	double expected, prob, term;
+	char ioBuf[160];
+	char buf[30];
+	UINT8 k, ball, common;
+
+	/* probability that two random draws have at least k common numbers (hypergeometric) */
+
+	tail[DRAW_BALL+1] = 0;
+
+	for (k=DRAW_BALL+1; k > 0; k--) {
+		tail[k-1] = tail[k] + (double) combCount(DRAW_BALL, k-1) * combCount(TOTAL_BALL-DRAW_BALL, DRAW_BALL-(k-1)) / combCount(TOTAL_BALL, DRAW_BALL);
+	}
+
+	fprintf(fp, "Draws within %lu days that have at least %d common numbers between dates %s - %s\n\n", (unsigned long) days, overlap, dateStart, dateEnd);
+
+	/* rows are the latest draws first, so the draws within the days of the row i are the rows after it */
+
+	for (i=0; i < pt->rows; i++)
+	{
+		for (j=i+1; j < pt->rows && pt->epochDay[i] - pt->epochDay[j] <= days; j++)
+		{
+			pairs++;
+
+			if ((common = overlapCountT(pt, i, j)) < overlap) continue;
+
+			found++;
+
+			formatDate(ioBuf, pt->day[i], pt->mon[i], pt->year[i]);
+			strcat(ioBuf, " : ");
+
+			for (k=0; k < pt->cols; k++) {
+				sprintf(buf, "%2d ", pt->balls[(UINT32) i*pt->cols + k]);
+				strcat(ioBuf, buf);
+			}
+
+			strcat(ioBuf, "      ");
+			formatDate(buf, pt->day[j], pt->mon[j], pt->year[j]);
+			strcat(ioBuf, buf);
+			strcat(ioBuf, " : ");
+
+			for (k=0; k < pt->cols; k++) {
+				sprintf(buf, "%2d ", pt->balls[(UINT32) j*pt->cols + k]);
+				strcat(ioBuf, buf);
+			}
+
+			sprintf(buf, "  %4lu days   (", (unsigned long) (pt->epochDay[i] - pt->epochDay[j]));
+			strcat(ioBuf, buf);
+
+			/* common numbers are the balls of the row i that are set in the bitmask of the row j */
+
+			mask = pt->mask + (UINT32) j*MASK_WORDS;
+
+			for (k=0; k < pt->cols; k++) 
+			{
+				ball = pt->balls[(UINT32) i*pt->cols + k];
+
+				if (ball && (mask[(ball-1) / MASK_BITS] & ((MASKWORD) 1 << ((ball-1) % MASK_BITS)))) {
+					sprintf(buf, "%2d,", ball);
+					strcat(ioBuf, buf);
+				}
+			}
+
+			ioBuf[strlen(ioBuf)-1] = ')';
+
+			sprintf(buf, "   1 in %.0f\n", 1.0 / tail[common]);
+			strcat(ioBuf, buf);
+
+			fputs(ioBuf, fp);
+		}
+	}
+
+	/* expected count of the near-duplicates of random draws and the Poisson probability of the count found or more */
+
+	expected = (double) pairs * tail[overlap];
+
+	for (x=0, prob=0, term=exp(-expected); x < found; x++) {
+		prob += term;
+		term *= expected / (x+1);
+	}
+
+	prob = (prob < 1) ? 1 - prob : 0;
+
+	if (found) fputs("\n", fp);
+
+	fprintf(fp, "Pairs of draws within %lu days: %lu, near-duplicates: %lu, expected for random draws: %.2f, probability of %lu or more: %.3g\n", 
+		(unsigned long) days, (unsigned long) pairs, (unsigned long) found, expected, (unsigned long) found, prob);
+	fprintf(fp, "\n1 in N: chance of as many common numbers for two random draws\n");
+}
+
+
+
+void monteCarlo(UINT32 histories, FILE *fp)
+{
+	struct TableXY *pt = winningDrawnBallsList;
+	struct MonteCarlo sim;
+	UINT8 k;
+	UINT16 t, threads = 1;
+	char *names[3] = {"chi-square of ball counts", "most drawn count", "least drawn count"};
+	char label[30];
+	double expected, observed, mean;
+	#ifdef USE_THREADS
+	pthread_t *workers;
+	#endif
+
+	if (pt->rows < 2) return;
+
+	sim.histories = histories;
+	sim.nextHistory = 0;
+	sim.rows = pt->rows;
+
+	for (k=0; k < SIMSTATS; k++) {
+		sim.sum[k] = 0;
+		sim.extreme[k] = 0;
+	}
+
+	getHistoryStats(pt->balls, pt->mask, pt->rows, sim.observed);
+
+	#ifdef USE_THREADS
+	threads = drawThreads ? drawThreads : (UINT16) sysconf(_SC_NPROCESSORS_ONLN);
+	if (threads < 1) threads = 1;
+	if (threads > 64) threads = 64;
+	#endif
+
+	if (fp != stdout) printf("%lu random histories of %lu draws are simulated...\n", (unsigned long) histories, (unsigned long) pt->rows);
+
+	#ifdef USE_THREADS
+	pthread_mutex_init(&sim.lock, NULL);
+
+	workers = (pthread_t *) malloc(sizeof(pthread_t)*threads);
+
+	for (t=1; workers && t < threads; t++) {
+		if (pthread_create(&workers[t], NULL, simulateWorker, &sim) != 0) break;
+	}
+
+	/* the main thread is the first worker */
+	simulateHistories(&sim);
+
+	while (workers && t > 1) pthread_join(workers[--t], NULL);
+
+	if (workers) free(workers);
+	pthread_mutex_destroy(&sim.lock);
+	#else
+	simulateHistories(&sim);
+	#endif
+
+	fprintf(fp, "Monte Carlo test of %lu random histories of %lu draws (%d of %d numbers) between dates %s - %s\n\n", 
+		(unsigned long) histories, (unsigned long) pt->rows, DRAW_BALL, TOTAL_BALL, dateStart, dateEnd);
+	fprintf(fp, "%-28s%16s%16s%10s\n\n", "", "observed", "random mean", "p-value");
+
+	/* expected count of a ball, the chi-square is the sum of the squares of the counts divided by it minus the draws of the balls */
+
+	expected = (double) pt->rows * DRAW_BALL / TOTAL_BALL;
+
+	for (k=0; k < SIMSTATS; k++)
+	{
+		observed = (double) sim.observed[k];
+		mean = sim.sum[k] / histories;
+
+		if (k == 0) {
+			observed = observed / expected - (double) pt->rows * DRAW_BALL;
+			mean = mean / expected - (double) pt->rows * DRAW_BALL;
+		}
+
+		if (k < 3) strcpy(label, names[k]);
+		else sprintf(label, "matched %d combinations", k-1);
+
+		fprintf(fp, "%-28s%16.2f%16.2f%10.4f\n", label, observed, mean, (double) (sim.extreme[k]+1) / (histories+1));
+	}
+
+	fprintf(fp, "\np-value: share of the random histories with the statistic as extreme as the draws (at least as large,\n");
+	fprintf(fp, "or at most as small for the least drawn count). A small p-value of the ball counts may point to a\n");
+	fprintf(fp, "systematic error of the machines and the balls, otherwise the draws are as even as random draws.\n");
+	fprintf(fp, "\nSeed: %lu\n", (unsigned long) randomSeed);
+}
+
+
+
+void simulateHistories(struct MonteCarlo *pm)
+{
+	UINTSUM stats[SIMSTATS];
+	UINT8 order[TOTAL_BALL];
+	UINT8 *balls;
+	MASKWORD *masks;
+	UINTROW r;
+	UINT32 h;
+	UINT8 i, j, k;
+
+	balls = (UINT8 *) malloc(sizeof(UINT8)*DRAW_BALL*(UINT32) pm->rows);
+	masks = (MASKWORD *) malloc(sizeof(MASKWORD)*MASK_WORDS*(UINT32) pm->rows);
+
+	if (balls == NULL || masks == NULL) {
+		if (balls) free(balls);
+		if (masks) free(masks);
+		return;
+	}
+
+	while (1)
+	{
+		#ifdef USE_THREADS
+		pthread_mutex_lock(&pm->lock);
+		#endif
+
+		h = pm->nextHistory;
+		if (h < pm->histories) pm->nextHistory++;
+
+		#ifdef USE_THREADS
+		pthread_mutex_unlock(&pm->lock);
+		#endif
+
+		if (h >= pm->histories) break;
+
+		seedRandom(&rng, randomSeed, h);
+
+		for (i=0; i < TOTAL_BALL; i++) {
+			order[i] = i+1;
+		}
+
+		/* draws of the history (partial shuffle of the balls, the order is not reset between the draws) */
+
+		for (r=0; r < pm->rows; r++) 
+		{
+			for (i=0; i < DRAW_BALL; i++) 
+			{
+				j = i + (UINT8) randomBelow(&rng, TOTAL_BALL-i);
+				k = order[i];
+				order[i] = order[j];
+				order[j] = k;
+			}
+
+			memcpy(balls + (UINT32) r*DRAW_BALL, order, DRAW_BALL);
+			setMaskX(masks + (UINT32) r*MASK_WORDS, order, DRAW_BALL);
+		}
+
+		getHistoryStats(balls, masks, pm->rows, stats);
+
+		#ifdef USE_THREADS
+		pthread_mutex_lock(&pm->lock);
+		#endif
+
+		for (k=0; k < SIMSTATS; k++) 
+		{
+			pm->sum[k] += (double) stats[k];
+
+			if (k == 2 ? stats[k] <= pm->observed[k] : stats[k] >= pm->observed[k]) pm->extreme[k]++;
+		}
+
+		#ifdef USE_THREADS
+		pthread_mutex_unlock(&pm->lock);
+		#endif
+	}
+
+	free(balls);
+	free(masks);
+}
+
+
+
+void getHistoryStats(UINT8 *balls, MASKWORD *masks, UINTROW rows, UINTSUM *stats)
+{
+	UINTROW counts[TOTAL_BALL+1];
+	UINTSUM pairs[DRAW_BALL+1];
+	UINTROW i, j;
+	UINT32 n;
+	UINT8 b, k;
+
+	for (b=0; b <= TOTAL_BALL; b++) {
+		counts[b] = 0;
+	}
+
+	for (n=0; n < (UINT32) rows*DRAW_BALL; n++) {
+		counts[balls[n]]++;
+	}
+
+	/* ball counts */
+
+	stats[0] = 0;
+	stats[1] = 0;
+	stats[2] = rows;
+
+	for (b=1; b <= TOTAL_BALL; b++) 
+	{
+		stats[0] += (UINTSUM) counts[b] * counts[b];
+
+		if (counts[b] > stats[1]) stats[1] = counts[b];
+		if (counts[b] < stats[2]) stats[2] = counts[b];
+	}
+
+	/* pairs of draws by their common numbers */
+
+	for (k=0; k <= DRAW_BALL; k++) {
+		pairs[k] = 0;
+	}
+
+	for (i=0; i < rows; i++) {
+		for (j=i+1; j < rows; j++) {
+			pairs[popCountMask(masks + (UINT32) i*MASK_WORDS, masks + (UINT32) j*MASK_WORDS)]++;
+		}
+	}
+
+	for (k=2; k <= DRAW_BALL; k++) 
+	{
+		stats[k+1] = 0;
+
+		for (b=k; b <= DRAW_BALL; b++) {
+			stats[k+1] += pairs[b] * combCount(b, k);
+		}
+	}
+}
+
+
+
+struct ListX * drawBallsByLucky(struct ListX *drawnBallsLucky, UINT8 drawNum, UINT8 totalBall, UINT8 drawBallCount)
+{
+	UINT8 i, j, x;
+	UINT32 n;
+	int ind1, ind2, ind3;
+	UINT8 ball1, ball2, ball3;
+	UINT8 *luckyRow;
+	struct LuckyPartners *lp = NULL;
+	UINT8 numOfAttempts = (UINT8) ceil(5*totalBall/drawBallCount);
+
+	#if defined(__MSDOS__)
+	if (drawNum == 1 || drawNum == 2) {
+		luckyBalls3 = getLuckyBallsFromFile(luckyBalls3, 3);
+		lp = createLuckyPartners(lp, luckyBalls3, 3, totalBall);
+		removeAllXY(luckyBalls3);
+	}
+	else {
+		luckyBalls2 = getLuckyBallsFromFile(luckyBalls2, 2);
+		lp = createLuckyPartners(lp, luckyBalls2, 2, totalBall);
+		removeAllXY(luckyBalls2);
+	}
+	#else
+	if (drawNum == 1 || drawNum == 2) {
+		lp = luckyPartners3;
+	}
+	else {
+		lp = luckyPartners2;
+	}
+	#endif
+
+	if (lp == NULL) 
+	{
+		/* there are no lucky numbers */
+		while (drawnBallsLucky->index < drawBallCount) {
+			ball2 = randomBelow(&rng, totalBall) +1;
+			if (seqSearchX1(drawnBallsLucky, ball2) < 0) appendItem(drawnBallsLucky, ball2);
+		}
+
+		bubbleSortXByKey(drawnBallsLucky);
+
+		return drawnBallsLucky;
+	}
+
+	if (drawNum == 1) x = 3;
+	else x = 2;
+
+	if (drawNum == 1) 
+	{
+		luckyRow = lp->balls + (UINT32) randomBelow(&rng, lp->rows) * lp->comb;
+		ind1 = randomBelow(&rng, 3);
+
+		if (ind1 == 0) 
+		{
+			ind2 = randomBelow(&rng, 2) +1;
+			if (ind2 == 1) ind3 = 2;
+			else ind3 = 1;
+		}
+		else if (ind1 == 1) 
+		{
+			ind2 = 0;
+			ind3 = 2;
+		}
+		else 
+		{
+			ind2 = randomBelow(&rng, 2);
+			if (ind2 == 0) ind3 = 1;
+			else ind3 = 0;
+		}
+
+		ball1 = luckyRow[ind1];
+		ball2 = luckyRow[ind2];
+		ball3 = luckyRow[ind3];
+
+		appendItem(drawnBallsLucky, ball1);
+		appendItem(drawnBallsLucky, ball2);
+		appendItem(drawnBallsLucky, ball3);
+	}
+	else
+	{
+		if (drawNum == 2) {
+			luckyRow = lp->balls + (UINT32) randomBelow(&rng, lp->rows) * lp->comb;
+		} else {
+			luckyRow = lp->balls + (UINT32) randomBelow(&rng, lp->top) * lp->comb;
+		}
+
+		ind1 = randomBelow(&rng, 2);
+		if (ind1 == 0) ind2 = 1;
+		else ind2 = 0;
+
+		ball1 = luckyRow[ind1];
+		appendItem(drawnBallsLucky, ball1);
+
+		ball2 = luckyRow[ind2];
+		appendItem(drawnBallsLucky, ball2);
+	}
+
+	for (i=0; i<drawBallCount-x; i++)
+	{
+		j = 0;
+		do {
+			/* a partner of ball2 in the top rows, or the second ball of a top row if ball2 has no partner */
+			n = lp->first[ball2+1] - lp->first[ball2];
+
+			if (n) ball2 = lp->partners[lp->first[ball2] + randomBelow(&rng, n)];
+			else ball2 = lp->balls[(UINT32) randomBelow(&rng, lp->top) * lp->comb + 1];
+
+			j++;
+		} while ((ind1 = seqSearchX1(drawnBallsLucky, ball2)) >= 0 && j <= numOfAttempts);
+
+		if (ind1 >= 0) {
+			do {
+				ball2 = randomBelow(&rng, drawBallCount) +1;
+			} while(seqSearchX1(drawnBallsLucky, ball2) >= 0);
+		}
+
+		appendItem(drawnBallsLucky, ball2);
+	}
+
+	#if defined(__MSDOS__)
+	removeLuckyPartners(lp);
+	#endif
+
+	bubbleSortXByKey(drawnBallsLucky);
+
+	return drawnBallsLucky;
+}
+
+
+
+void drawBalls(struct ListXY *coupon, UINT8 totalBall, UINT8 drawBallCount, UINT8 drawRowCount, UINT8 drawByNorm, UINT8 drawByLeft, UINT8 drawByBlend1, UINT8 drawByBlend2, UINT8 drawBySide, UINT8 drawByRand, UINT8 drawByLucky)
+{
+	UINT8 i, j;
+	UINT8 found = 0;
+	UINT8 matchComb = 0;
+	UINT8 elimComb = 0;
+	UINT8 autoCalc = 1;
+	UINT8 noMatch, elim;
+	char label[22];
+	char pLabel[11];
+	UINT8 drawCountDown = drawRowCount;
+	UINT8 luckyNum = 0;
+	UINT8 numOfAttempts;
+
+	struct ListX *drawnBalls = NULL;
+	struct ListX2 *ballSortOrder = NULL;
+
+	numOfAttempts = (UINT8) ceil(5*totalBall/drawBallCount);
+
+	if (drawBallCount == 1) {
+		ballSortOrder = plusNumberBallsDrawCount;
+		strcpy(pLabel, "PlusNumber");
+	}
+	else {
+		ballSortOrder = winningBallsDrawCount;
+		strcpy(pLabel, "Numbers");
+	}
+
+	#ifdef USE_THREADS
+	if (drawThreads) {
+		drawBallsByWorkers(coupon, ballSortOrder, pLabel, totalBall, drawBallCount, drawRowCount, numOfAttempts, drawByNorm, drawByLeft, drawByBlend1, drawByBlend2, drawBySide, drawByRand, drawByLucky);
+		return;
+	}
+	#endif
+
+	for (j=0; drawCountDown; j++)
+	{
+		if (j%2 == 0)
+		{
+			/* normal distribution */
+			if (drawByNorm && drawCountDown)
+			{
+				strcpy(label, "(normal distribution)");
+				drawnBalls = createListX(drawnBalls, drawBallCount, label, 0, 0, 0, 0, 0);
+
+				if (autoCalc && drawBallCount > 1) {
+					matchComb = 0;
+					elimComb = 2;
+				}
+
+				for (i=0; i < numOfAttempts; i++)
+				{
+					drawnBalls = drawBallByNorm(drawnBalls, ballSortOrder, totalBall, drawBallCount, matchComb, elimComb);
+
+					if (drawBallCount == 1) break;
+
+					noMatch = 0;
+
+					if (matchComb == 3) {
+						noMatch = !searchLucky(drawnBalls, 3, NULL);
+					}
+
+					elim = elimByLucky(drawnBalls, elimComb);
+
+					if (!(noMatch || elim)) {
+						if (i < ceil((double) numOfAttempts/4)) {
+							found = searchCoupon(coupon, drawnBalls, drawBallCount, 1);
+						} else if (i < ceil((double) numOfAttempts/2)) {
+							if (drawBallCount == 1) break;
+							found = searchCoupon(coupon, drawnBalls, drawBallCount, 2);
+						} else if (i < ceil(3* (double) numOfAttempts/4)) {
+							found = searchCoupon(coupon, drawnBalls, drawBallCount, 3);
+						} else {
+							found = searchCoupon(coupon, drawnBalls, drawBallCount, 4);
+						}
+
+						if(!found) break;
+					}
+
+					if (autoCalc && drawBallCount > 1) {
+						if (i < ceil((double) numOfAttempts/4)) {matchComb = 0; elimComb = 2;}
+						else if (i < ceil((double) numOfAttempts/2)) {matchComb = 0; elimComb = 3;}
+						else if (i < ceil(3* (double) numOfAttempts/4)) {matchComb = 3; elimComb = 4;}
+						else {matchComb = 0; elimComb = 0;}
+					}
+				}
+
+				appendList(coupon, drawnBalls);
+				drawCountDown--;
+
+				printPercentOfProgress(pLabel, (UINT32) (drawRowCount-drawCountDown), (UINT32) drawRowCount);
+			}
+		}
+		else
+		{
+			/* Left Stacked */
+			if (drawByLeft && drawCountDown)
+			{
+				strcpy(label, "(left stacked)");
+				drawnBalls = createListX(drawnBalls, drawBallCount, label, 0, 0, 0, 0, 0);
+
+				if (autoCalc && drawBallCount > 1) {
+					matchComb = 0;
+					elimComb = 2;
+				}
+
+				for (i=0; i < numOfAttempts; i++)
+				{
+					drawnBalls = drawBallByLeft(drawnBalls, ballSortOrder, totalBall, drawBallCount, matchComb, elimComb);
+
+					if (drawBallCount == 1) break;
+
+					noMatch = 0;
+
+					if (matchComb == 3) {
+						noMatch = !searchLucky(drawnBalls, 3, NULL);
+					}
+
+					elim = elimByLucky(drawnBalls, elimComb);
+
+					if (!(noMatch || elim)) {
+						if (i < ceil((double) numOfAttempts/4)) {
+							found = searchCoupon(coupon, drawnBalls, drawBallCount, 1);
+						} else if (i < ceil((double) numOfAttempts/2)) {
+							if (drawBallCount == 1) break;
+							found = searchCoupon(coupon, drawnBalls, drawBallCount, 2);
+						} else if (i < ceil(3* (double) numOfAttempts/4)) {
+							found = searchCoupon(coupon, drawnBalls, drawBallCount, 3);
+						} else {
+							found = searchCoupon(coupon, drawnBalls, drawBallCount, 4);
+						}
+
+						if(!found) break;
+					}
+
+					if (autoCalc && drawBallCount > 1) {
+						if (i < ceil((double) numOfAttempts/4)) {matchComb = 0; elimComb = 2;}
+						else if (i < ceil((double) numOfAttempts/2)) {matchComb = 0; elimComb = 3;}
+						else if (i < ceil(3* (double) numOfAttempts/4)) {matchComb = 3; elimComb = 4;}
+						else {matchComb = 0; elimComb = 0;}
+					}
+				}
+
+				appendList(coupon, drawnBalls);
+				drawCountDown--;
+
+				printPercentOfProgress(pLabel, (UINT32) (drawRowCount-drawCountDown), (UINT32) drawRowCount);
+			}
+		}
+
+		if (j%2 == 0)
+		{
+			/* Blend 1 */
+			if (drawByBlend1 && drawCountDown)
+			{
+				strcpy(label, "(blend 1)");
+				drawnBalls = createListX(drawnBalls, drawBallCount, label, 0, 0, 0, 0, 0);
+
+				if (autoCalc && drawBallCount > 1) {
+					matchComb = 0;
+					elimComb = 2;
+				}
+
+				for (i=0; i < numOfAttempts; i++)
+				{
+					drawnBalls = drawBallByBlend1(drawnBalls, ballSortOrder, totalBall, drawBallCount, matchComb, elimComb);
+
+					if (drawBallCount == 1) break;
+
+					noMatch = 0;
+
+					if (matchComb == 3) {
+						noMatch = !searchLucky(drawnBalls, 3, NULL);
+					}
+
+					elim = elimByLucky(drawnBalls, elimComb);
+
+					if (!(noMatch || elim)) {
+						if (i < ceil((double) numOfAttempts/4)) {
+							found = searchCoupon(coupon, drawnBalls, drawBallCount, 1);
+						} else if (i < ceil((double) numOfAttempts/2)) {
+							if (drawBallCount == 1) break;
+							found = searchCoupon(coupon, drawnBalls, drawBallCount, 2);
+						} else if (i < ceil(3* (double) numOfAttempts/4)) {
+							found = searchCoupon(coupon, drawnBalls, drawBallCount, 3);
+						} else {
+							found = searchCoupon(coupon, drawnBalls, drawBallCount, 4);
+						}
+
+						if(!found) break;
+					}
+
+					if (autoCalc && drawBallCount > 1) {
+						if (i < ceil((double) numOfAttempts/4)) {matchComb = 0; elimComb = 2;}
+						else if (i < ceil((double) numOfAttempts/2)) {matchComb = 0; elimComb = 3;}
+						else if (i < ceil(3* (double) numOfAttempts/4)) {matchComb = 3; elimComb = 4;}
+						else {matchComb = 0; elimComb = 0;}
+					}
+				}
+
+				appendList(coupon, drawnBalls);
+				drawCountDown--;
+
+				printPercentOfProgress(pLabel, (UINT32) (drawRowCount-drawCountDown), (UINT32) drawRowCount);
+			}
+		}
+		else
+		{
+			/* Blend 2 */
+			if (drawByBlend2 && drawCountDown)
+			{
+				strcpy(label, "(blend 2)");
+				drawnBalls = createListX(drawnBalls, drawBallCount, label, 0, 0, 0, 0, 0);
+
+				if (autoCalc && drawBallCount > 1) {
+					matchComb = 0;
+					elimComb = 2;
+				}
+
+				for (i=0; i < numOfAttempts; i++)
+				{
+					drawnBalls = drawBallByBlend2(drawnBalls, ballSortOrder, totalBall, drawBallCount, matchComb, elimComb);
+
+					if (drawBallCount == 1) break;
+
+					noMatch = 0;
+
+					if (matchComb == 3) {
+						noMatch = !searchLucky(drawnBalls, 3, NULL);
+					}
+
+					elim = elimByLucky(drawnBalls, elimComb);
+
+					if (!(noMatch || elim)) {
+						if (i < ceil((double) numOfAttempts/4)) {
+							found = searchCoupon(coupon, drawnBalls, drawBallCount, 1);
+						} else if (i < ceil((double) numOfAttempts/2)) {
+							if (drawBallCount == 1) break;
+							found = searchCoupon(coupon, drawnBalls, drawBallCount, 2);
+						} else if (i < ceil(3* (double) numOfAttempts/4)) {
+							found = searchCoupon(coupon, drawnBalls, drawBallCount, 3);
+						} else {
+							found = searchCoupon(coupon, drawnBalls, drawBallCount, 4);
+						}
+
+						if(!found) break;
+					}
+
+					if (autoCalc && drawBallCount > 1) {
+						if (i < ceil((double) numOfAttempts/4)) {matchComb = 0; elimComb = 2;}
+						else if (i < ceil((double) numOfAttempts/2)) {matchComb = 0; elimComb = 3;}
+						else if (i < ceil(3* (double) numOfAttempts/4)) {matchComb = 3; elimComb = 4;}
+						else {matchComb = 0; elimComb = 0;}
+					}
+				}
+
+				appendList(coupon, drawnBalls);
+				drawCountDown--;
+
+				printPercentOfProgress(pLabel, (UINT32) (drawRowCount-drawCountDown), (UINT32) drawRowCount);
+			}
+		}
+
+		/* Side Stacked */
+		if (drawBySide && drawCountDown)
+		{
+			strcpy(label, "(side stacked)");
+			drawnBalls = createListX(drawnBalls, drawBallCount, label, 0, 0, 0, 0, 0);
+
+			if (autoCalc && drawBallCount > 1) {
+				matchComb = 0;
+				elimComb = 2;
+			}
+
+			for (i=0; i < numOfAttempts; i++)
+			{
+				drawnBalls = drawBallBySide(drawnBalls, ballSortOrder, totalBall, drawBallCount, matchComb, elimComb);
+
+				if (drawBallCount == 1) break;
+
+				noMatch = 0;
+
+				if (matchComb == 3) {
+					noMatch = !searchLucky(drawnBalls, 3, NULL);
+				}
+
+				elim = elimByLucky(drawnBalls, elimComb);
+
+				if (!(noMatch || elim)) {
+					if (i < ceil((double) numOfAttempts/4)) {
+						found = searchCoupon(coupon, drawnBalls, drawBallCount, 1);
+					} else if (i < ceil((double) numOfAttempts/2)) {
+						if (drawBallCount == 1) break;
+						found = searchCoupon(coupon, drawnBalls, drawBallCount, 2);
+					} else if (i < ceil(3* (double) numOfAttempts/4)) {
+						found = searchCoupon(coupon, drawnBalls, drawBallCount, 3);
+					} else {
+						found = searchCoupon(coupon, drawnBalls, drawBallCount, 4);
+					}
+
+					if(!found) break;
+				}
+
+				if (autoCalc && drawBallCount > 1) {
+					if (i < ceil((double) numOfAttempts/4)) {matchComb = 0; elimComb = 2;}
+					else if (i < ceil((double) numOfAttempts/2)) {matchComb = 0; elimComb = 3;}
+					else if (i < ceil(3* (double) numOfAttempts/4)) {matchComb = 3; elimComb = 4;}
+					else {matchComb = 0; elimComb = 0;}
+				}
+			}
+
+			appendList(coupon, drawnBalls);
+			drawCountDown--;
+
+			printPercentOfProgress(pLabel, (UINT32) (drawRowCount-drawCountDown), (UINT32) drawRowCount);
+		}
+
+		/* Random */
+		if (drawByRand && drawCountDown)
+		{
+			strcpy(label, "(random)");
+			drawnBalls = createListX(drawnBalls, drawBallCount, label, 0, 0, 0, 0, 0);
+
+			if (autoCalc && drawBallCount > 1) {
+				matchComb = 0;
+				elimComb = 2;
+			}
+
+			for (i=0; i < numOfAttempts; i++)
+			{
+				drawnBalls = drawBallByRand(drawnBalls, ballSortOrder, totalBall, drawBallCount, matchComb, elimComb);
+
+				if (drawBallCount == 1) break;
+
+				noMatch = 0;
+
+				if (matchComb == 3) {
+					noMatch = !searchLucky(drawnBalls, 3, NULL);
+				}
+
+				elim = elimByLucky(drawnBalls, elimComb);
+
+				if (!(noMatch || elim)) {
+					if (i < ceil((double) numOfAttempts/4)) {
+						found = searchCoupon(coupon, drawnBalls, drawBallCount, 1);
+					} else if (i < ceil((double) numOfAttempts/2)) {
+						if (drawBallCount == 1) break;
+						found = searchCoupon(coupon, drawnBalls, drawBallCount, 2);
+					} else if (i < ceil(3* (double) numOfAttempts/4)) {
+						found = searchCoupon(coupon, drawnBalls, drawBallCount, 3);
+					} else {
+						found = searchCoupon(coupon, drawnBalls, drawBallCount, 4);
+					}
+
+					if(!found) break;
+				}
+
+				if (autoCalc && drawBallCount > 1) {
+					if (i < ceil((double) numOfAttempts/4)) {matchComb = 0; elimComb = 2;}
+					else if (i < ceil((double) numOfAttempts/2)) {matchComb = 0; elimComb = 3;}
+					else if (i < ceil(3* (double) numOfAttempts/4)) {matchComb = 3; elimComb = 4;}
+					else {matchComb = 0; elimComb = 0;}
+				}
+			}
+
+			appendList(coupon, drawnBalls);
+			drawCountDown--;
+
+			printPercentOfProgress(pLabel, (UINT32) (drawRowCount-drawCountDown), (UINT32) drawRowCount);
+		}
+
+		/* Lucky */
+		if (drawByLucky && drawCountDown)
+		{
+			if (drawBallCount > 1) // winning numbers
+			{
+				luckyNum = (j%3)+1;
+
+				if (luckyNum == 1) strcpy(label, "(lucky 3)");
+				else if (luckyNum == 2) strcpy(label, "(2 of lucky 3)");
+				else strcpy(label, "(lucky 2)");
+
+				drawnBalls = createListX(drawnBalls, drawBallCount, label, 0, 0, 0, 0, 0);
+    	        drawnBalls = drawBallsByLucky(drawnBalls, luckyNum, totalBall, drawBallCount);
+			}
+			else // plusNumber
+			{
+				strcpy(label, "plus number");
+				drawnBalls = createListX(drawnBalls, drawBallCount, label, 0, 0, 0, 0, 0);
+
+				for (i=0; i < numOfAttempts; i++) 
+				{
+					if (i < ceil((double) numOfAttempts/4)) {
+    					if (j%2 == 0) drawnBalls = drawBallByNorm(drawnBalls, ballSortOrder, totalBall, drawBallCount, 0, 0);
+						else drawnBalls = drawBallByLeft(drawnBalls, ballSortOrder, totalBall, drawBallCount, 0, 0);
+					} else if (i < ceil((double) numOfAttempts/2)) {
+    					if (j%2 == 0) drawnBalls = drawBallByBlend1(drawnBalls, ballSortOrder, totalBall, drawBallCount, 0, 0);
+						else drawnBalls = drawBallByBlend2(drawnBalls, ballSortOrder, totalBall, drawBallCount, 0, 0);
+					} else if (i < ceil(3* (double) numOfAttempts/4)) {
+    					drawnBalls = drawBallBySide(drawnBalls, ballSortOrder, totalBall, drawBallCount, 0, 0);
+					} else {
+    					drawnBalls = drawBallByRand(drawnBalls, ballSortOrder, totalBall, drawBallCount, 0, 0);
+					}
+
+					if (couponRows(coupon) > ceil(1.25*totalBall/drawBallCount)) break;
+    				found = searchCoupon(coupon, drawnBalls, drawBallCount, 1);
+					if(!found) break;
+				}
+			}
+
+			appendList(coupon, drawnBalls);
+			drawCountDown--;
+
+			printPercentOfProgress(pLabel, (UINT32) (drawRowCount-drawCountDown), (UINT32) drawRowCount);
+		}
+	}
+}
 
-		sprintf(buf, "%d\n", nl->val);
-		strcat(ioBuf, buf);
 
-		nl = nl->next;
 
-		fputs(ioBuf, fp);
-	}
+#ifdef USE_THREADS
 
-	fclose(fp);
+void drawBallsByWorkers(struct ListXY *coupon, struct ListX2 *ballSortOrder, char *pLabel, UINT8 totalBall, UINT8 drawBallCount, UINT8 drawRowCount, UINT8 numOfAttempts, UINT8 drawByNorm, UINT8 drawByLeft, UINT8 drawByBlend1, UINT8 drawByBlend2, UINT8 drawBySide, UINT8 drawByRand, UINT8 drawByLucky)
+{
+	UINT8 i, j, k, r;
+	UINT8 first, last;
+	UINT8 found;
+	UINT8 luckyNum;
+	UINT16 t, threads, want;
+	char label[22];
+	struct DrawJob job;
+	struct DrawRow *row;
+	struct Random mainRng;
+	pthread_t *workers;
 
-	return 1;
-}
+	struct ListX *drawnBalls = NULL;
+	struct ListX *attempt = NULL;
 
+	if (!(drawByNorm || drawByLeft || drawByBlend1 || drawByBlend2 || drawBySide || drawByRand || drawByLucky)) return;
 
+	job.rows = (struct DrawRow *) malloc(sizeof(struct DrawRow)*drawRowCount);
+	job.units = (UINT16 *) malloc(sizeof(UINT16)*drawRowCount*numOfAttempts);
+	job.ballSortOrder = ballSortOrder;
+	job.totalBall = totalBall;
+	job.drawBallCount = drawBallCount;
+	job.numOfAttempts = numOfAttempts;
+	pthread_mutex_init(&job.lock, NULL);
 
-struct ListXY * getLuckyBallsFromFile(struct ListXY *luckyBalls, UINT8 comb)
-{
-	UINT16 i;
-	UINT8 j, k;
-	int n1, n2, n3, n4, val;
-	//UINT8 keys[DRAW_BALL+1];
-	char lbFile[14];
-	char ioBuf[20];
-	char s[6];
+	threads = drawThreads;
+	workers = (pthread_t *) malloc(sizeof(pthread_t)*threads);
 
-	FILE *fp;
+	/* gaussIndex creates its table on first use, the workers only read it */
 
-	struct ListX *drawList = NULL;
+	if (totalBall > 1 && gaussTables[totalBall] == NULL) {
+		gaussTables[totalBall] = createGaussTable(totalBall);
+	}
 
-	switch (comb)
+	/* rows in the order of drawBalls */
+
+	for (j=0, r=0; r < drawRowCount; j++)
 	{
-	case 2 : strcpy(lbFile, LBL2SWAPFILE); break;
-	case 3 : strcpy(lbFile, LBL3SWAPFILE); break;
-	case 4 : strcpy(lbFile, LBL4SWAPFILE); break;
-	default: break;
-	}
+		if (j%2 == 0) {
+			if (drawByNorm && r < drawRowCount) setDrawRow(&job, &job.rows[r++], DRAWBYNORM, j);
+		} else {
+			if (drawByLeft && r < drawRowCount) setDrawRow(&job, &job.rows[r++], DRAWBYLEFT, j);
+		}
 
-	if ((fp = fopen(lbFile, "r")) == NULL) {
-		printf("Can't open file %s\n", lbFile);
-		pressAnyKeyToExit();
-		return NULL;
+		if (j%2 == 0) {
+			if (drawByBlend1 && r < drawRowCount) setDrawRow(&job, &job.rows[r++], DRAWBYBLEND1, j);
+		} else {
+			if (drawByBlend2 && r < drawRowCount) setDrawRow(&job, &job.rows[r++], DRAWBYBLEND2, j);
+		}
+
+		if (drawBySide && r < drawRowCount) setDrawRow(&job, &job.rows[r++], DRAWBYSIDE, j);
+		if (drawByRand && r < drawRowCount) setDrawRow(&job, &job.rows[r++], DRAWBYRAND, j);
+		if (drawByLucky && r < drawRowCount) setDrawRow(&job, &job.rows[r++], DRAWBYLUCKY, j);
 	}
 
-	for (i=0; fgets(ioBuf, 20, fp) && i<UINT16MAX; i++)
+	mainRng = rng;
+
+	attempt = createListX(attempt, drawBallCount, NULL, 0, 0, 0, 0, 0);
+
+	for (first=0; first < drawRowCount; )
 	{
-		drawList = createListX(drawList, comb, NULL, 0, 0, 0, 0, 0);
+		last = (drawRowCount - first > 2*threads) ? first + 2*threads : drawRowCount;
 
-		if (comb == 2) 
+		/* first attempts of the rows ahead, and an attempt for each thread to the row whose attempts are all rejected */
+
+		job.unitCount = job.nextUnit = 0;
+
+		for (r=first; r < last; r++)
 		{
-			s[0] = ioBuf[0];
-			s[1] = ioBuf[1];
-			s[2] = '\0';
-			n1 = atoi(s);
+			row = &job.rows[r];
 
-			s[0] = ioBuf[2];
-			s[1] = ioBuf[3];
-			s[2] = '\0';
-			n2 = atoi(s);
+			if (row->mode == DRAWBYLUCKY && drawBallCount > 1) continue;
 
-			for (j=0, k=4; !(ioBuf[k]=='\n'||ioBuf[k]=='\0'); j++, k++){
-				s[j] = ioBuf[k];
+			if (row->count == 0) {
+				want = 1;
+			} else if (row->next == row->count) {
+				want = row->count + threads;
+			} else {
+				continue;
 			}
-			s[j] = '\0';
-			val = atoi(s);
-/*			
-			keys[0] = (UINT8) n1;
-			keys[1] = (UINT8) n2;
-			keys[2] = '\0';
-*/
-			drawList->balls[0] = (UINT8) n1;
-			drawList->balls[1] = (UINT8) n2;
-			drawList->index += 2;
+
+			if (want > numOfAttempts) want = numOfAttempts;
+
+			for (i=row->count; i < want; i++)
+			{
+				if (i > 0) {
+					row->streams[i] = row->streams[i-1];
+					jumpRandom(&row->streams[i]);
+				}
+
+				job.units[job.unitCount++] = (UINT16) r << 8 | i;
+			}
+
+			row->count = (UINT8) want;
 		}
-		else if (comb == 3) 
+
+		if (job.unitCount)
 		{
-			s[0] = ioBuf[0];
-			s[1] = ioBuf[1];
-			s[2] = '\0';
-			n1 = atoi(s);
+			for (t=0; t < threads && t < job.unitCount; t++) {
+				if (pthread_create(&workers[t], NULL, drawWorker, &job) != 0) break;
+			}
 
-			s[0] = ioBuf[2];
-			s[1] = ioBuf[3];
-			s[2] = '\0';
-			n2 = atoi(s);
+			while (t > 0) pthread_join(workers[--t], NULL);
 
-			s[0] = ioBuf[4];
-			s[1] = ioBuf[5];
-			s[2] = '\0';
-			n3 = atoi(s);
+			/* attempts left if a thread couldn't be created */
 
-			for (j=0, k=6; !(ioBuf[k]=='\n'||ioBuf[k]=='\0'); j++, k++){
-				s[j] = ioBuf[k];
-			}
-			s[j] = '\0';
-			val = atoi(s);
-/*
-			keys[0] = (UINT8) n1;
-			keys[1] = (UINT8) n2;
-			keys[2] = (UINT8) n3;
-			keys[3] = '\0';
-*/
-			drawList->balls[0] = (UINT8) n1;
-			drawList->balls[1] = (UINT8) n2;
-			drawList->balls[2] = (UINT8) n3;
-			drawList->index += 3;
+			drawWorker(&job);
 		}
-		else if (comb == 4)
+
+		/* rows are added to the coupon in order, the first row with no accepted attempt waits for the next round */
+
+		for (; first < last; first++)
 		{
-			s[0] = ioBuf[0];
-			s[1] = ioBuf[1];
-			s[2] = '\0';
-			n1 = atoi(s);
+			row = &job.rows[first];
 
-			s[0] = ioBuf[2];
-			s[1] = ioBuf[3];
-			s[2] = '\0';
-			n2 = atoi(s);
+			if (row->mode == DRAWBYLUCKY && drawBallCount > 1)
+			{
+				luckyNum = (row->j%3)+1;
 
-			s[0] = ioBuf[4];
-			s[1] = ioBuf[5];
-			s[2] = '\0';
-			n3 = atoi(s);
+				if (luckyNum == 1) strcpy(label, "(lucky 3)");
+				else if (luckyNum == 2) strcpy(label, "(2 of lucky 3)");
+				else strcpy(label, "(lucky 2)");
 
-			s[0] = ioBuf[6];
-			s[1] = ioBuf[7];
-			s[2] = '\0';
-			n4 = atoi(s);
+				rng = row->streams[0];
 
-			for (j=0, k=8; !(ioBuf[k]=='\n'||ioBuf[k]=='\0'); j++, k++){
-				s[j] = ioBuf[k];
+				drawnBalls = createListX(drawnBalls, drawBallCount, label, 0, 0, 0, 0, 0);
+				drawnBalls = drawBallsByLucky(drawnBalls, luckyNum, totalBall, drawBallCount);
 			}
-			s[j] = '\0';
-			val = atoi(s);
-/*
-			keys[0] = (UINT8) n1;
-			keys[1] = (UINT8) n2;
-			keys[2] = (UINT8) n3;
-			keys[3] = (UINT8) n4;
-			keys[4] = '\0';
-*/
-			drawList->balls[0] = (UINT8) n1;
-			drawList->balls[1] = (UINT8) n2;
-			drawList->balls[2] = (UINT8) n3;
-			drawList->balls[3] = (UINT8) n4;
-			drawList->index += 4;
-		}
+			else
+			{
+				for (; row->next < row->count; row->next++)
+				{
+					i = row->next;
+					found = 1;
 
-		drawList->val = (UINT16) val;
-		//appendItems(drawList, keys);
-		appendList(luckyBalls, drawList);
-	}
+					removeAllX(attempt);
 
-	fclose(fp);
+					for (k=0; k < drawBallCount; k++) {
+						appendItem(attempt, row->balls[i*drawBallCount+k]);
+					}
 
-	return luckyBalls;
-}
+					if (row->mode == DRAWBYLUCKY) {
+						if (couponRows(coupon) > ceil(1.25*totalBall/drawBallCount)) found = 0;
+						else found = searchCoupon(coupon, attempt, drawBallCount, 1);
+					} else if (drawBallCount == 1) {
+						found = 0;
+					} else if (row->eligible[i]) {
+						if (i < ceil((double) numOfAttempts/4)) {
+							found = searchCoupon(coupon, attempt, drawBallCount, 1);
+						} else if (i < ceil((double) numOfAttempts/2)) {
+							found = searchCoupon(coupon, attempt, drawBallCount, 2);
+						} else if (i < ceil(3* (double) numOfAttempts/4)) {
+							found = searchCoupon(coupon, attempt, drawBallCount, 3);
+						} else {
+							found = searchCoupon(coupon, attempt, drawBallCount, 4);
+						}
+					}
 
+					if (!found || i == numOfAttempts-1) break;
+				}
 
+				if (row->next == row->count) break;
 
-void calcMatchCombCount()
-{
-	UINT16 i, j;
-	struct ListX *aPrvDrawn1 = NULL;
-	struct ListX *aPrvDrawn2 = NULL;
+				switch (row->mode)
+				{
+				case DRAWBYNORM : strcpy(label, "(normal distribution)"); break;
+				case DRAWBYLEFT : strcpy(label, "(left stacked)"); break;
+				case DRAWBYBLEND1 : strcpy(label, "(blend 1)"); break;
+				case DRAWBYBLEND2 : strcpy(label, "(blend 2)"); break;
+				case DRAWBYSIDE : strcpy(label, "(side stacked)"); break;
+				case DRAWBYRAND : strcpy(label, "(random)"); break;
+				default : strcpy(label, "plus number"); break;
+				}
 
-	aPrvDrawn1 = winningDrawnBallsList->list;
+				drawnBalls = createListX(drawnBalls, drawBallCount, label, 0, 0, 0, 0, 0);
 
-	for (i=0; aPrvDrawn1 && i<winningBallRows; i++)
-	{
-		aPrvDrawn2 = aPrvDrawn1->next;
+				for (k=0; k < drawBallCount; k++) {
+					appendItem(drawnBalls, getKey(attempt, k));
+				}
+			}
 
-		for (j=i+1; aPrvDrawn2 && j<winningBallRows; j++) 
-		{
-			match2comb += search2CombX(aPrvDrawn2, aPrvDrawn1, NULL, NULL);
-			match3comb += search3CombX(aPrvDrawn2, aPrvDrawn1, NULL, NULL);
-			match4comb += search4CombX(aPrvDrawn2, aPrvDrawn1, NULL, NULL);
-			match5comb += search5CombX(aPrvDrawn2, aPrvDrawn1);
+			appendList(coupon, drawnBalls);
 
-			aPrvDrawn2 = aPrvDrawn2->next;
-		}
+			free(row->balls);
+			free(row->eligible);
+			free(row->streams);
 
-		aPrvDrawn1 = aPrvDrawn1->next;
+			printPercentOfProgress(pLabel, (UINT32) first+1, (UINT32) drawRowCount);
+		}
 	}
+
+	rng = mainRng;
+
+	free(attempt->balls);
+	free(attempt);
+	free(workers);
+	free(job.units);
+	free(job.rows);
+	pthread_mutex_destroy(&job.lock);
 }
 
 
 
-void calcMatchComb(UINT8 comb, FILE *fp)
+void setDrawRow(struct DrawJob *job, struct DrawRow *row, UINT8 mode, UINT8 j)
 {
-	UINT16 i, j;
-	UINT32 k, x;
-	UINT8 d1, m1, d2, m2;
-	UINT16 y1, y2;
-	UINT16 dDif;
-	UINT32 matchComb;
-	UINT8 found;
-	struct ListX *aPrvDrawn1 = NULL;
-	struct ListX *aPrvDrawn2 = NULL;
-	char lbBuf[119];
-	char pLabel[10];
-	char date1[11], date2[11];
-	char lastDate[11];
+	row->mode = mode;
+	row->j = j;
+	row->count = 0;
+	row->next = 0;
+	row->balls = (UINT8 *) malloc(sizeof(UINT8)*job->numOfAttempts*job->drawBallCount);
+	row->eligible = (UINT8 *) malloc(sizeof(UINT8)*job->numOfAttempts);
+	row->streams = (struct Random *) malloc(sizeof(struct Random)*job->numOfAttempts);
+
+	seedRandom(&row->streams[0], nextRandom(&rng), 0);
+}
 
-	strcpy(pLabel, "Progress");
 
-	if (comb >= 2 && comb <= 5) 
-	{
-		puts("Matched combinations of numbers from previous draws:\n");
-		if (fp != NULL) fprintf(fp, "Matched combinations of numbers from previous draws:\n\n");
 
-		switch (comb)
-		{
-		case 2 : matchComb = match2comb; break;
-		case 3 : matchComb = match3comb; break;
-		case 4 : matchComb = match4comb; break;
-		case 5 : matchComb = match5comb; break;
-		default: break;
-		}
+void *drawWorker(void *arg)
+{
+	struct DrawJob *job = (struct DrawJob *) arg;
+	UINT16 unit;
 
-        printf("Matched %d combinations: %lu\n\n", comb, (unsigned long) matchComb);
-        if (fp != NULL) fprintf(fp, "Matched %d combinations: %lu\n\n", comb, (unsigned long) matchComb);
+	struct ListX *drawnBalls = NULL;
+	struct ListX2 *ballSortOrder = NULL;
 
-		aPrvDrawn1 = winningDrawnBallsList->list;
+	drawnBalls = createListX(drawnBalls, job->drawBallCount, NULL, 0, 0, 0, 0, 0);
+	ballSortOrder = createListX2(ballSortOrder, job->ballSortOrder->size);
 
-		for (i=0, k=0, x=0; x<matchComb && aPrvDrawn1 && i<winningBallRows; i++) 
-		{
-			if (comb >= 2 && comb <= 4) {
-					 printPercentOfProgress(pLabel, k, (UINT32) ceil((UINT32) winningBallRows*((UINT32) winningBallRows-1)/2));
-			}
+	for (;;)
+	{
+		pthread_mutex_lock(&job->lock);
 
-			aPrvDrawn2 = aPrvDrawn1->next;
+		if (job->nextUnit >= job->unitCount) {
+			pthread_mutex_unlock(&job->lock);
+			break;
+		}
 
-			for (j=i+1; aPrvDrawn2 && j<winningBallRows; j++, k++) 
-			{
-				switch (comb)
-				{
-				case 2 : found = search2CombX(aPrvDrawn2, aPrvDrawn1, NULL, lbBuf); break;
-				case 3 : found = search3CombX(aPrvDrawn2, aPrvDrawn1, NULL, lbBuf); break;
-				case 4 : found = search4CombX(aPrvDrawn2, aPrvDrawn1, NULL, lbBuf); break;
-				case 5 : found = search5CombX(aPrvDrawn2, aPrvDrawn1); break;
-				default: break;
-				}
+		unit = job->units[job->nextUnit++];
 
-				if (found) 
-				{
-					x++;
+		pthread_mutex_unlock(&job->lock);
 
-					if (x == matchComb && comb < 5) printPercentOfProgress(pLabel, 1, 1);
+		drawAttempt(job, &job->rows[unit >> 8], (UINT8) (unit & 0xff), drawnBalls, ballSortOrder);
+	}
 
-					formatDate(date1, aPrvDrawn1->day, aPrvDrawn1->mon, aPrvDrawn1->year);
+	free(ballSortOrder->balls);
+	free(ballSortOrder->vals);
+	free(ballSortOrder);
+	free(drawnBalls->balls);
+	free(drawnBalls);
 
-					if (strcmp(lastDate, date1) != 0) 
-					{
-						if (comb >= 5) {
-							puts("\n--------------------------------------------------------------------------------");
-							printf("\n%s : ", date1);
-						}
+	return NULL;
+}
 
-						if (fp != NULL) {
-							fputs("\n--------------------------------------------------------------------------------", fp);
-							fprintf(fp, "\n%s : ", date1);
-						}
 
-						if (comb >= 5) printListXByKey(aPrvDrawn1, 0, fp);
-						else  printListXByKey(aPrvDrawn1, 2, fp);
-						
-						if (comb >= 5) printf("   ");
-						if (fp != NULL) fprintf(fp, "   ");
-						
-						y1 = aPrvDrawn1->year;
-						m1 = aPrvDrawn1->mon;
-						d1 = aPrvDrawn1->day;
-						formatDate(date1, d1, m1, y1);
-					}
-					else {
-						if (comb >= 5) printf("                               ");
-						if (fp != NULL) fprintf(fp, "                               ");
-					}
-					
-					formatDate(date2, aPrvDrawn2->day, aPrvDrawn2->mon, aPrvDrawn2->year);
 
-					if (comb >= 5) printf("    %s : ", date2);
-					if (fp != NULL) fprintf(fp, "    %s : ", date2);
-			
-					if (comb >= 5) printListXByKey(aPrvDrawn2, 0, fp);
-					else  printListXByKey(aPrvDrawn2, 2, fp);
-		
-					y2 = aPrvDrawn2->year;
-					m2 = aPrvDrawn2->mon;
-					d2 = aPrvDrawn2->day;
-		
-					dDif = dateDiff(d2, m2, y2, d1, m1, y1);
+void *topWorker(void *arg)
+{
+	struct TopSearch *ps = (struct TopSearch *) arg;
+	struct TopHeap *ph;
 
-					if (comb >= 5) printf("   %4d days", dDif);
-					if (fp != NULL) fprintf(fp, "   %4d days", dDif);
-		
-					if (comb != 5) {
-						if (comb >= 5) printf("   %s", lbBuf);
-						if (fp != NULL) fprintf(fp, "   %s", lbBuf);
-					}
+	pthread_mutex_lock(&ps->lock);
+	ph = &ps->heaps[ps->nextHeap++];
+	pthread_mutex_unlock(&ps->lock);
 
-					if (comb >= 5) puts("");
-					if (fp != NULL) fprintf(fp, "\n");
-					strcpy(lastDate, date1);
-				}
+	scoreTopTickets(ps, ph);
 
-				aPrvDrawn2 = aPrvDrawn2->next;
-			}
+	return NULL;
+}
 
-			aPrvDrawn1 = aPrvDrawn1->next;
-		}
 
-		if (matchComb) {
-			if (comb >= 5) puts("\n--------------------------------------------------------------------------------\n");
-			if (fp != NULL) fputs("\n--------------------------------------------------------------------------------\n", fp);
-		}
-	}
+
+void *simulateWorker(void *arg)
+{
+	simulateHistories((struct MonteCarlo *) arg);
+
+	return NULL;
 }
 
 
 
-struct ListX * drawBallsByLucky(struct ListX *drawnBallsLucky, UINT8 drawNum, UINT8 totalBall, UINT8 drawBallCount)
+void drawAttempt(struct DrawJob *job, struct DrawRow *row, UINT8 i, struct ListX *drawnBalls, struct ListX2 *ballSortOrder)
 {
-	UINT8 i, j, k, x;
-	UINT16 lbsLen, index = 0;
-	UINT16 lucky2MinVal = 0;
-	UINT16 lucky2MaxVal = 0;
-	int ind1, ind2, ind3;
-	UINT8 ball1, ball2, ball3;
-	struct ListXY *luckyBalls = NULL;
-	struct ListX *luckyRow2 = NULL;
-	struct ListX *luckyRow3 = NULL;
-	UINT8 numOfAttempts = (UINT8) ceil(5*totalBall/drawBallCount);
+	UINT8 k;
+	UINT8 matchComb = 0;
+	UINT8 elimComb = 0;
+	UINT8 noMatch, elim;
+	UINT8 totalBall = job->totalBall;
+	UINT8 drawBallCount = job->drawBallCount;
+	UINT8 numOfAttempts = job->numOfAttempts;
 
-	#if defined(__MSDOS__)
-	if (drawNum == 1) {
-		luckyBalls3 = getLuckyBallsFromFile(luckyBalls3, 3);
-	}
-	else if (drawNum == 2) {
-		luckyBalls3 = getLuckyBallsFromFile(luckyBalls3, 3);
-	}
-	else {
-		luckyBalls2 = getLuckyBallsFromFile(luckyBalls2, 2);
+
+	rng = row->streams[i];
+
+	/* the draw functions sort the ball sort order, every attempt starts from the same order */
+
+	memcpy(ballSortOrder->balls, job->ballSortOrder->balls, sizeof(UINT8)*job->ballSortOrder->index);
+	memcpy(ballSortOrder->vals, job->ballSortOrder->vals, sizeof(UINTROW)*job->ballSortOrder->index);
+	ballSortOrder->index = job->ballSortOrder->index;
+
+	if (row->mode == DRAWBYLUCKY) // plus number
+	{
+		if (i < ceil((double) numOfAttempts/4)) {
+			if (row->j%2 == 0) drawnBalls = drawBallByNorm(drawnBalls, ballSortOrder, totalBall, drawBallCount, 0, 0);
+			else drawnBalls = drawBallByLeft(drawnBalls, ballSortOrder, totalBall, drawBallCount, 0, 0);
+		} else if (i < ceil((double) numOfAttempts/2)) {
+			if (row->j%2 == 0) drawnBalls = drawBallByBlend1(drawnBalls, ballSortOrder, totalBall, drawBallCount, 0, 0);
+			else drawnBalls = drawBallByBlend2(drawnBalls, ballSortOrder, totalBall, drawBallCount, 0, 0);
+		} else if (i < ceil(3* (double) numOfAttempts/4)) {
+			drawnBalls = drawBallBySide(drawnBalls, ballSortOrder, totalBall, drawBallCount, 0, 0);
+		} else {
+			drawnBalls = drawBallByRand(drawnBalls, ballSortOrder, totalBall, drawBallCount, 0, 0);
+		}
+
+		memcpy(row->balls + i*drawBallCount, drawnBalls->balls, drawBallCount);
+		row->eligible[i] = 1;
+		return;
 	}
-	#endif
 
-	if (drawNum == 1) {
-		  luckyBalls = luckyBalls3;
+	/* attempt i of drawBalls draws with the combinations set after attempt i-1 */
+
+	if (drawBallCount > 1) {
+		k = i ? i-1 : 0;
+
+		if (k < ceil((double) numOfAttempts/4)) {matchComb = 0; elimComb = 2;}
+		else if (k < ceil((double) numOfAttempts/2)) {matchComb = 0; elimComb = 3;}
+		else if (k < ceil(3* (double) numOfAttempts/4)) {matchComb = 3; elimComb = 4;}
+		else {matchComb = 0; elimComb = 0;}
 	}
-	else if (drawNum == 2) {
-        luckyBalls = luckyBalls3;
+
+	switch (row->mode)
+	{
+	case DRAWBYNORM : drawnBalls = drawBallByNorm(drawnBalls, ballSortOrder, totalBall, drawBallCount, matchComb, elimComb); break;
+	case DRAWBYLEFT : drawnBalls = drawBallByLeft(drawnBalls, ballSortOrder, totalBall, drawBallCount, matchComb, elimComb); break;
+	case DRAWBYBLEND1 : drawnBalls = drawBallByBlend1(drawnBalls, ballSortOrder, totalBall, drawBallCount, matchComb, elimComb); break;
+	case DRAWBYBLEND2 : drawnBalls = drawBallByBlend2(drawnBalls, ballSortOrder, totalBall, drawBallCount, matchComb, elimComb); break;
+	case DRAWBYSIDE : drawnBalls = drawBallBySide(drawnBalls, ballSortOrder, totalBall, drawBallCount, matchComb, elimComb); break;
+	default : drawnBalls = drawBallByRand(drawnBalls, ballSortOrder, totalBall, drawBallCount, matchComb, elimComb); break;
 	}
-	else {
-        luckyBalls = luckyBalls2;
+
+	memcpy(row->balls + i*drawBallCount, drawnBalls->balls, drawBallCount);
+	row->eligible[i] = 1;
+
+	if (drawBallCount == 1) return;
+
+	noMatch = 0;
+
+	if (matchComb == 3) {
+		noMatch = !searchLucky(drawnBalls, 3, NULL);
 	}
 
-	lbsLen = lengthY(luckyBalls);
+	elim = elimByLucky(drawnBalls, elimComb);
 
-	bubbleSortYByVal(luckyBalls, -1);
-	bubbleSortYByVal2(luckyBalls, -1);
+	row->eligible[i] = !(noMatch || elim);
+}
 
-	luckyRow2 = getListXByIndex(luckyBalls, lbsLen-1);
-	lucky2MinVal = luckyRow2->val;
-	luckyRow2 = getListXByIndex(luckyBalls, 0);
-	lucky2MaxVal = luckyRow2->val;
+#endif
 
-	for (index=0; index < (UINT16) ceil(2*lbsLen/3) && getValXY(luckyBalls, index) > (UINT16) ceil((lucky2MinVal+lucky2MaxVal)/2); index++);
 
-	if (index < 10) index = lbsLen;
 
-	if (drawNum == 1) x = 3;
-	else x = 2;
+UINTROW getDrawnBallsList(struct TableXY *ballList, struct TableXY *bonusList, char *fileName)
+{
+	UINTROW i=0, k=0;
+	int d1, m1, y1;
+	UINT8 keys[DRAW_BALL+1];
+	int fields[FILEFIELDS];
+	UINT32 length;
+	char *buf, *pos, *end;
+	UINT8 j;
 
-	if (drawNum == 1) 
+	if ((buf = mapFile(fileName, &length)) == NULL) {
+		return 0;
+	}
+
+	end = buf + length;
+
+	for (pos=buf; pos<end && i<UINTROWMAX && k<UINTROWMAX;)
 	{
-		luckyBalls = shuffleListXY(luckyBalls);
-		luckyRow3 = getListXByIndex(luckyBalls, (UINT16) rand() % lbsLen);
-		ind1 = rand()%3;
+		if (parseLine(&pos, end, fields, FILEFIELDS) < FILEFIELDS) continue;
 
-		if (ind1 == 0) 
-		{
-			ind2 = rand()%2 +1;
-			if (ind2 == 1) ind3 = 2;
-			else ind3 = 1;
-		}
-		else if (ind1 == 1) 
+		d1 = fields[0];
+		m1 = fields[1];
+		y1 = fields[2];
+
+		if (ballList) 
 		{
-			ind2 = 0;
-			ind3 = 2;
+			for (j=0; j<ballList->cols; j++) {
+				keys[j] = (UINT8) fields[BALLFIELD+j];
+			}
+			if (!appendRowT(ballList, keys, (UINT16) y1, (UINT8) m1, (UINT8) d1)) break;
+			i++;
 		}
-		else 
+
+		if (bonusList) 
 		{
-			ind2 = rand()%2;
-			if (ind2 == 0) ind3 = 1;
-			else ind3 = 0;
+			for (j=0; j<bonusList->cols; j++) {
+				keys[j] = (UINT8) fields[BONUSFIELD+j];
+			}
+			if (!appendRowT(bonusList, keys, (UINT16) y1, (UINT8) m1, (UINT8) d1)) break;
+			k++;
 		}
+	}
 
-		ball1 = getKey(luckyRow3, ind1);
-		ball2 = getKey(luckyRow3, ind2);
-		ball3 = getKey(luckyRow3, ind3);
+	unmapFile(buf, length);
 
-		appendItem(drawnBallsLucky, ball1);
-		appendItem(drawnBallsLucky, ball2);
-		appendItem(drawnBallsLucky, ball3);
-	}
-	else
-	{
-		if (drawNum == 2) {
-			luckyBalls = shuffleListXY(luckyBalls);
-			luckyRow2 = getListXByIndex(luckyBalls, (UINT16) rand() % lbsLen);
-		} else {
-			luckyRow2 = getListXByIndex(luckyBalls, (UINT16) rand() % index);
-		}
+	return ballList ? i : k;
+}
 
-		ind1 = rand()%2;
-		if (ind1 == 0) ind2 = 1;
-		else ind2 = 0;
 
-		ball1 = getKey(luckyRow2, ind1);
-		appendItem(drawnBallsLucky, ball1);
 
-		ball2 = getKey(luckyRow2, ind2);
-		appendItem(drawnBallsLucky, ball2);
-	}
+char *mapFile(char *fileName, UINT32 *length)
+{
+	char *buf = NULL;
 
-	bubbleSortYByVal(luckyBalls, -1);
-	bubbleSortYByVal2(luckyBalls, -1);
+	#ifdef USE_MMAP
+	int fd;
+	struct stat st;
 
-	for (i=0; i<drawBallCount-x; i++)
-	{
-		j = 0;
-		do {
-			k = 0;
-			do {
-				luckyRow2 = getListXByIndex(luckyBalls, rand() % index);
-				k++;
-			} while ((ind1 = seqSearchX1(luckyRow2, ball2)) < 0 && k <= numOfAttempts);
+	if ((fd = open(fileName, O_RDONLY)) < 0) return NULL;
+
+	if (fstat(fd, &st) < 0 || st.st_size == 0) {
+		close(fd);
+		return NULL;
+	}
 
-			if (ind1 < 0) ind1 = 0;
+	buf = (char *) mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
 
-			if (ind1 == 0) ind2 = 1;
-			else ind2 = 0;
+	if (buf == (char *) MAP_FAILED) return NULL;
 
-			ball2 = getKey(luckyRow2, ind2);
-			j++;
-		} while ((ind1 = seqSearchX1(drawnBallsLucky, ball2)) >= 0 && j <= numOfAttempts);
+	*length = (UINT32) st.st_size;
+	#else
+	FILE *fp;
+	long size;
 
-		if (ind1 >= 0) {
-			do {
-				ball2 = (rand() % drawBallCount) +1;
-			} while(seqSearchX1(drawnBallsLucky, ball2) >= 0);
-		}
+	if ((fp = fopen(fileName, "rb")) == NULL) return NULL;
 
-		appendItem(drawnBallsLucky, ball2);
+	fseek(fp, 0, SEEK_END);
+	size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+
+	if (size <= 0 || (buf = (char *) malloc((size_t) size)) == NULL) {
+		fclose(fp);
+		return NULL;
 	}
 
-	#if defined(__MSDOS__)
-	removeAllXY(luckyBalls);
+	*length = (UINT32) fread(buf, 1, (size_t) size, fp);
+	fclose(fp);
 	#endif
 
-	bubbleSortXByKey(drawnBallsLucky);
-
-	return drawnBallsLucky;
+	return buf;
 }
 
 
 
-void drawBalls(struct ListXY *coupon, UINT8 totalBall, UINT8 drawBallCount, UINT8 drawRowCount, UINT8 drawByNorm, UINT8 drawByLeft, UINT8 drawByBlend1, UINT8 drawByBlend2, UINT8 drawBySide, UINT8 drawByRand, UINT8 drawByLucky)
+void unmapFile(char *buf, UINT32 length)
 {
-	UINT8 i, j, k;
-	UINT8 found = 0;
-	UINT8 matchComb = 0;
-	UINT8 elimComb = 0;
-	UINT8 autoCalc = 1;
-	UINT8 noMatch, elim;
-	char label[22];
-	char pLabel[11];
-	UINT8 drawCountDown = drawRowCount;
-	UINT8 luckyNum = 0;
-	UINT16 dDiff;
-	UINT8 numOfAttempts;
+	if (buf == NULL) return;
 
-	struct ListX *drawnBalls = NULL;
-	struct ListX *fc = NULL;
-	struct ListX2 *ballSortOrder = NULL;
-	struct ListXY *foundComb = NULL;
+	#ifdef USE_MMAP
+	munmap(buf, (size_t) length);
+	#else
+	free(buf);
+	#endif
+}
 
-	foundComb = createListXY(foundComb);
 
-	numOfAttempts = (UINT8) ceil(5*totalBall/drawBallCount);
 
-	if (drawBallCount == 1) {
-		ballSortOrder = plusNumberBallsDrawCount;
-		strcpy(pLabel, "PlusNumber");
-	}
-	else {
-		ballSortOrder = winningBallsDrawCount;
-		strcpy(pLabel, "Numbers");
-	}
+UINT8 parseLine(char **pos, char *end, int *fields, UINT8 maxFields)
+{
+	char *p = *pos;
+	UINT8 n = 0;
+	int val;
 
-	for (j=0; drawCountDown; j++)
+	while (p < end && *p != '\n')
 	{
-		if (j%2 == 0)
+		if (*p >= '0' && *p <= '9') 
 		{
-			/* normal distribution */
-			if (drawByNorm && drawCountDown)
-			{
-				strcpy(label, "(normal distribution)");
-				drawnBalls = createListX(drawnBalls, drawBallCount, label, 0, 0, 0, 0, 0);
+			for (val=0; p < end && *p >= '0' && *p <= '9'; p++) {
+				val = val*10 + (*p - '0');
+			}
 
-				if (autoCalc && drawBallCount > 1) {
-					matchComb = 0;
-					elimComb = 2;
-				}
+			if (n < maxFields) fields[n++] = val;
+		}
+		else p++;
+	}
 
-				for (i=0; i < numOfAttempts; i++)
-				{
-					drawnBalls = drawBallByNorm(drawnBalls, ballSortOrder, totalBall, drawBallCount, matchComb, elimComb);
+	if (p < end) p++;
 
-					if (drawBallCount == 1) break;
+	*pos = p;
 
-					noMatch = 0;
+	return n;
+}
 
-					if (matchComb == 3) {
-						noMatch = !search3CombXY(luckyBalls3, drawnBalls, NULL);
-					}
 
-					elim = 0;
+#ifdef USE_SNAPSHOT
 
-					switch (elimComb)
-					{
-					case 4 : elim = search4CombXY(luckyBalls4, drawnBalls, foundComb);
-					case 3 : if (!elim) elim = search3CombXY(luckyBalls3, drawnBalls, foundComb);
-					case 2 : if (!elim) elim = search2CombXY(luckyBalls2, drawnBalls, foundComb);
-					default: break;
-					}
+UINT32 hashBuffer(char *buf, UINT32 length)
+{
+	UINT32 i, hash = 2166136261U;
 
-					if (elim)
-					{
-						fc = foundComb->list;
-
-						for (k=0; fc && k<lengthY(foundComb); k++) 
-						{
-							dDiff = dateDiff(fc->day, fc->mon, fc->year, currDay, currMon, currYear);
-
-							if (dDiff >= fc->val2 && ((double) fc->val * (double) fc->val2 / (double) drawnDays) >= 0.49) {
-								elim = 0;
-								break;
-							}
-							
-							fc = fc->next;
-						}
-					}
+	for (i=0; i<length; i++) {
+		hash ^= (UINT8) buf[i];
+		hash *= 16777619U;
+	}
 
-					if (!(noMatch || elim)) {
-						if (i < ceil((double) numOfAttempts/4)) {
-							found = search1BallXY(coupon, drawnBalls, drawBallCount);
-						} else if (i < ceil((double) numOfAttempts/2)) {
-							if (drawBallCount == 1) break;
-							found = search2CombXY(coupon, drawnBalls, NULL);
-						} else if (i < ceil(3* (double) numOfAttempts/4)) {
-							found = search3CombXY(coupon, drawnBalls, NULL);
-						} else {
-							found = search4CombXY(coupon, drawnBalls, NULL);
-						}
+	return hash;
+}
 
-						if(!found) break;
-					}
 
-					if (autoCalc && drawBallCount > 1) {
-						if (i < ceil((double) numOfAttempts/4)) {matchComb = 0; elimComb = 2;}
-						else if (i < ceil((double) numOfAttempts/2)) {matchComb = 0; elimComb = 3;}
-						else if (i < ceil(3* (double) numOfAttempts/4)) {matchComb = 3; elimComb = 4;}
-						else {matchComb = 0; elimComb = 0;}
-					}
-				}
 
-				appendList(coupon, drawnBalls);
-				drawCountDown--;
+UINT8 getSnapshotHeader(char *fileName, struct SnapshotHeader *header)
+{
+	struct stat st;
+	UINT32 length;
+	char *buf;
 
-				printPercentOfProgress(pLabel, (UINT32) (drawRowCount-drawCountDown), (UINT32) drawRowCount);
-			}
-		}
-		else
-		{
-			/* Left Stacked */
-			if (drawByLeft && drawCountDown)
-			{
-				strcpy(label, "(left stacked)");
-				drawnBalls = createListX(drawnBalls, drawBallCount, label, 0, 0, 0, 0, 0);
+	if (stat(fileName, &st) != 0) return 0;
 
-				if (autoCalc && drawBallCount > 1) {
-					matchComb = 0;
-					elimComb = 2;
-				}
+	if ((buf = mapFile(fileName, &length)) == NULL) return 0;
 
-				for (i=0; i < numOfAttempts; i++)
-				{
-					drawnBalls = drawBallByLeft(drawnBalls, ballSortOrder, totalBall, drawBallCount, matchComb, elimComb);
+	header->magic = SNAPSHOTMAGIC;
+	header->version = SNAPSHOTVERSION;
+	header->layout = ((UINT32) sizeof(UINTROW) << 24) | ((UINT32) DRAW_BALL << 16) | ((UINT32) TOTAL_BALL << 8) | FILEFIELDS;
+	header->fileSize = (UINT32) st.st_size;
+	header->fileTime = (UINT32) st.st_mtime;
+	header->fileHash = hashBuffer(buf, length);
 
-					if (drawBallCount == 1) break;
+	unmapFile(buf, length);
+
+	return 1;
+}
+
+
+
+UINT8 readBytes(char **pos, char *end, void *data, UINT32 size)
+{
+	if ((UINT32) (end - *pos) < size) return 0;
+
+	memcpy(data, *pos, size);
+	*pos += size;
+
+	return 1;
+}
+
+
+
+UINT8 saveTableT(FILE *fp, struct TableXY *pt)
+{
+	if (fwrite(&pt->rows, sizeof(UINTROW), 1, fp) != 1) return 0;
+	if (fwrite(&pt->cols, sizeof(UINT8), 1, fp) != 1) return 0;
+
+	if (pt->rows == 0) return 1;
+
+	if (fwrite(pt->balls, sizeof(UINT8)*pt->cols, pt->rows, fp) != pt->rows) return 0;
+	if (fwrite(pt->year, sizeof(UINT16), pt->rows, fp) != pt->rows) return 0;
+	if (fwrite(pt->mon, sizeof(UINT8), pt->rows, fp) != pt->rows) return 0;
+	if (fwrite(pt->day, sizeof(UINT8), pt->rows, fp) != pt->rows) return 0;
+
+	return 1;
+}
+
+
+
+UINT8 loadTableT(char **pos, char *end, struct TableXY *pt)
+{
+	UINTROW i, rows;
+	UINT16 year;
+	UINT8 cols;
+	UINT8 *balls, *years, *mons, *days;
+
+	if (!readBytes(pos, end, &rows, sizeof(UINTROW))) return 0;
+	if (!readBytes(pos, end, &cols, sizeof(UINT8)) || cols != pt->cols) return 0;
+
+	if ((UINT32) (end - *pos) < (UINT32) rows*(cols + sizeof(UINT16) + 2)) return 0;
+
+	balls = (UINT8 *) *pos;
+	years = balls + (UINT32) rows*cols;
+	mons = years + (UINT32) rows*sizeof(UINT16);
+	days = mons + rows;
+	*pos = (char *) (days + rows);
+
+	for (i=0; i<rows; i++) 
+	{
+		memcpy(&year, years + (UINT32) i*sizeof(UINT16), sizeof(UINT16));
+		if (!appendRowT(pt, balls + (UINT32) i*cols, year, mons[i], days[i])) return 0;
+	}
 
-					noMatch = 0;
+	return 1;
+}
 
-					if (matchComb == 3) {
-						noMatch = !search3CombXY(luckyBalls3, drawnBalls, NULL);
-					}
 
-					elim = 0;
 
-					switch (elimComb)
-					{
-					case 4 : elim = search4CombXY(luckyBalls4, drawnBalls, foundComb);
-					case 3 : if (!elim) elim = search3CombXY(luckyBalls3, drawnBalls, foundComb);
-					case 2 : if (!elim) elim = search2CombXY(luckyBalls2, drawnBalls, foundComb);
-					default: break;
-					}
+UINT8 saveListX2(FILE *fp, struct ListX2 *pl)
+{
+	if (fwrite(&pl->index, sizeof(UINT8), 1, fp) != 1) return 0;
 
-					if (elim)
-					{
-						fc = foundComb->list;
-
-						for (k=0; fc && k<lengthY(foundComb); k++) 
-						{
-							dDiff = dateDiff(fc->day, fc->mon, fc->year, currDay, currMon, currYear);
-
-							if (dDiff >= fc->val2 && ((double) fc->val * (double) fc->val2 / (double) drawnDays) >= 0.49) {
-								elim = 0;
-								break;
-							}
-							
-							fc = fc->next;
-						}
-					}
+	if (pl->index == 0) return 1;
 
-					if (!(noMatch || elim)) {
-						if (i < ceil((double) numOfAttempts/4)) {
-							found = search1BallXY(coupon, drawnBalls, drawBallCount);
-						} else if (i < ceil((double) numOfAttempts/2)) {
-							if (drawBallCount == 1) break;
-							found = search2CombXY(coupon, drawnBalls, NULL);
-						} else if (i < ceil(3* (double) numOfAttempts/4)) {
-							found = search3CombXY(coupon, drawnBalls, NULL);
-						} else {
-							found = search4CombXY(coupon, drawnBalls, NULL);
-						}
+	if (fwrite(pl->balls, sizeof(UINT8), pl->index, fp) != pl->index) return 0;
+	if (fwrite(pl->vals, sizeof(UINTROW), pl->index, fp) != pl->index) return 0;
 
-						if(!found) break;
-					}
+	return 1;
+}
 
-					if (autoCalc && drawBallCount > 1) {
-						if (i < ceil((double) numOfAttempts/4)) {matchComb = 0; elimComb = 2;}
-						else if (i < ceil((double) numOfAttempts/2)) {matchComb = 0; elimComb = 3;}
-						else if (i < ceil(3* (double) numOfAttempts/4)) {matchComb = 3; elimComb = 4;}
-						else {matchComb = 0; elimComb = 0;}
-					}
-				}
 
-				appendList(coupon, drawnBalls);
-				drawCountDown--;
 
-				printPercentOfProgress(pLabel, (UINT32) (drawRowCount-drawCountDown), (UINT32) drawRowCount);
-			}
-		}
+UINT8 loadListX2(char **pos, char *end, struct ListX2 *pl)
+{
+	UINT8 index;
 
-		if (j%2 == 0)
-		{
-			/* Blend 1 */
-			if (drawByBlend1 && drawCountDown)
-			{
-				strcpy(label, "(blend 1)");
-				drawnBalls = createListX(drawnBalls, drawBallCount, label, 0, 0, 0, 0, 0);
+	if (!readBytes(pos, end, &index, sizeof(UINT8)) || index > pl->size) return 0;
+	if (!readBytes(pos, end, pl->balls, sizeof(UINT8)*index)) return 0;
+	if (!readBytes(pos, end, pl->vals, sizeof(UINTROW)*index)) return 0;
 
-				if (autoCalc && drawBallCount > 1) {
-					matchComb = 0;
-					elimComb = 2;
-				}
+	pl->index = index;
 
-				for (i=0; i < numOfAttempts; i++)
-				{
-					drawnBalls = drawBallByBlend1(drawnBalls, ballSortOrder, totalBall, drawBallCount, matchComb, elimComb);
+	return 1;
+}
 
-					if (drawBallCount == 1) break;
 
-					noMatch = 0;
 
-					if (matchComb == 3) {
-						noMatch = !search3CombXY(luckyBalls3, drawnBalls, NULL);
-					}
+UINT8 saveListXY(FILE *fp, struct ListXY *pl)
+{
+	struct ListX *nl;
+	UINT32 count;
 
-					elim = 0;
+	for (count=0, nl=pl->list; nl; nl=nl->next) {
+		count++;
+	}
 
-					switch (elimComb)
-					{
-					case 4 : elim = search4CombXY(luckyBalls4, drawnBalls, foundComb);
-					case 3 : if (!elim) elim = search3CombXY(luckyBalls3, drawnBalls, foundComb);
-					case 2 : if (!elim) elim = search2CombXY(luckyBalls2, drawnBalls, foundComb);
-					default: break;
-					}
+	if (fwrite(&count, sizeof(UINT32), 1, fp) != 1) return 0;
 
-					if (elim)
-					{
-						fc = foundComb->list;
-
-						for (k=0; fc && k<lengthY(foundComb); k++) 
-						{
-							dDiff = dateDiff(fc->day, fc->mon, fc->year, currDay, currMon, currYear);
-
-							if (dDiff >= fc->val2 && ((double) fc->val * (double) fc->val2 / (double) drawnDays) >= 0.49) {
-								elim = 0;
-								break;
-							}
-							
-							fc = fc->next;
-						}
-					}
+	for (nl=pl->list; nl; nl=nl->next)
+	{
+		if (fwrite(&nl->index, sizeof(UINT8), 1, fp) != 1) return 0;
+		if (fwrite(nl->balls, sizeof(UINT8), nl->index, fp) != nl->index) return 0;
+		if (fwrite(&nl->val, sizeof(UINTROW), 1, fp) != 1) return 0;
+		if (fwrite(&nl->val2, sizeof(UINTDAY), 1, fp) != 1) return 0;
+		if (fwrite(&nl->year, sizeof(UINT16), 1, fp) != 1) return 0;
+		if (fwrite(&nl->mon, sizeof(UINT8), 1, fp) != 1) return 0;
+		if (fwrite(&nl->day, sizeof(UINT8), 1, fp) != 1) return 0;
+	}
 
-					if (!(noMatch || elim)) {
-						if (i < ceil((double) numOfAttempts/4)) {
-							found = search1BallXY(coupon, drawnBalls, drawBallCount);
-						} else if (i < ceil((double) numOfAttempts/2)) {
-							if (drawBallCount == 1) break;
-							found = search2CombXY(coupon, drawnBalls, NULL);
-						} else if (i < ceil(3* (double) numOfAttempts/4)) {
-							found = search3CombXY(coupon, drawnBalls, NULL);
-						} else {
-							found = search4CombXY(coupon, drawnBalls, NULL);
-						}
+	return 1;
+}
 
-						if(!found) break;
-					}
 
-					if (autoCalc && drawBallCount > 1) {
-						if (i < ceil((double) numOfAttempts/4)) {matchComb = 0; elimComb = 2;}
-						else if (i < ceil((double) numOfAttempts/2)) {matchComb = 0; elimComb = 3;}
-						else if (i < ceil(3* (double) numOfAttempts/4)) {matchComb = 3; elimComb = 4;}
-						else {matchComb = 0; elimComb = 0;}
-					}
-				}
 
-				appendList(coupon, drawnBalls);
-				drawCountDown--;
+UINT8 loadListXY(char **pos, char *end, struct ListXY *pl)
+{
+	struct ListX *lb = NULL;
+	struct ListX *last = NULL;
+	UINT32 i, count;
+	UINTROW val;
+	UINTDAY val2;
+	UINT16 year;
+	UINT8 index, mon, day;
+	UINT8 keys[DRAW_BALL];
 
-				printPercentOfProgress(pLabel, (UINT32) (drawRowCount-drawCountDown), (UINT32) drawRowCount);
-			}
-		}
-		else
-		{
-			/* Blend 2 */
-			if (drawByBlend2 && drawCountDown)
-			{
-				strcpy(label, "(blend 2)");
-				drawnBalls = createListX(drawnBalls, drawBallCount, label, 0, 0, 0, 0, 0);
+	if (!readBytes(pos, end, &count, sizeof(UINT32))) return 0;
 
-				if (autoCalc && drawBallCount > 1) {
-					matchComb = 0;
-					elimComb = 2;
-				}
+	for (i=0; i<count; i++)
+	{
+		if (!readBytes(pos, end, &index, sizeof(UINT8)) || index == 0 || index > DRAW_BALL) return 0;
+		if (!readBytes(pos, end, keys, sizeof(UINT8)*index)) return 0;
+		if (!readBytes(pos, end, &val, sizeof(UINTROW))) return 0;
+		if (!readBytes(pos, end, &val2, sizeof(UINTDAY))) return 0;
+		if (!readBytes(pos, end, &year, sizeof(UINT16))) return 0;
+		if (!readBytes(pos, end, &mon, sizeof(UINT8))) return 0;
+		if (!readBytes(pos, end, &day, sizeof(UINT8))) return 0;
+
+		lb = createListX(lb, index, NULL, val, val2, year, mon, day);
+		memcpy(lb->balls, keys, index);
+		lb->index = index;
+
+		/* appended to the tail, so the order of the list is kept */
+		if (last) last->next = lb;
+		else pl->list = lb;
+
+		last = lb;
+	}
 
-				for (i=0; i < numOfAttempts; i++)
-				{
-					drawnBalls = drawBallByBlend2(drawnBalls, ballSortOrder, totalBall, drawBallCount, matchComb, elimComb);
+	return 1;
+}
 
-					if (drawBallCount == 1) break;
 
-					noMatch = 0;
+SINT32 newRowsT(struct TableXY *pt, struct TableXY *old)
+{
+	UINTROW i, n;
 
-					if (matchComb == 3) {
-						noMatch = !search3CombXY(luckyBalls3, drawnBalls, NULL);
-					}
+	if (pt->cols != old->cols || pt->rows < old->rows) return -1;
 
-					elim = 0;
+	n = pt->rows - old->rows;
 
-					switch (elimComb)
-					{
-					case 4 : elim = search4CombXY(luckyBalls4, drawnBalls, foundComb);
-					case 3 : if (!elim) elim = search3CombXY(luckyBalls3, drawnBalls, foundComb);
-					case 2 : if (!elim) elim = search2CombXY(luckyBalls2, drawnBalls, foundComb);
-					default: break;
-					}
+	for (i=0; i<old->rows; i++) 
+	{
+		if (pt->epochDay[n+i] != old->epochDay[i]) return -1;
+		if (memcmp(getRowT(pt, n+i), getRowT(old, i), pt->cols) != 0) return -1;
+	}
 
-					if (elim)
-					{
-						fc = foundComb->list;
-
-						for (k=0; fc && k<lengthY(foundComb); k++) 
-						{
-							dDiff = dateDiff(fc->day, fc->mon, fc->year, currDay, currMon, currYear);
-
-							if (dDiff >= fc->val2 && ((double) fc->val * (double) fc->val2 / (double) drawnDays) >= 0.49) {
-								elim = 0;
-								break;
-							}
-							
-							fc = fc->next;
-						}
-					}
+	return (SINT32) n;
+}
 
-					if (!(noMatch || elim)) {
-						if (i < ceil((double) numOfAttempts/4)) {
-							found = search1BallXY(coupon, drawnBalls, drawBallCount);
-						} else if (i < ceil((double) numOfAttempts/2)) {
-							if (drawBallCount == 1) break;
-							found = search2CombXY(coupon, drawnBalls, NULL);
-						} else if (i < ceil(3* (double) numOfAttempts/4)) {
-							found = search3CombXY(coupon, drawnBalls, NULL);
-						} else {
-							found = search4CombXY(coupon, drawnBalls, NULL);
-						}
 
-						if(!found) break;
-					}
 
-					if (autoCalc && drawBallCount > 1) {
-						if (i < ceil((double) numOfAttempts/4)) {matchComb = 0; elimComb = 2;}
-						else if (i < ceil((double) numOfAttempts/2)) {matchComb = 0; elimComb = 3;}
-						else if (i < ceil(3* (double) numOfAttempts/4)) {matchComb = 3; elimComb = 4;}
-						else {matchComb = 0; elimComb = 0;}
-					}
-				}
+void updateBallCountX2(struct ListX2 *pl, struct TableXY *pt, UINTROW newRows)
+{
+	UINTROW r;
+	UINT8 i;
+	UINT8 *balls;
 
-				appendList(coupon, drawnBalls);
-				drawCountDown--;
+	for (r=0; r<newRows; r++) 
+	{
+		balls = getRowT(pt, r);
 
-				printPercentOfProgress(pLabel, (UINT32) (drawRowCount-drawCountDown), (UINT32) drawRowCount);
-			}
+		for (i=0; i<pt->cols; i++) {
+			if (balls[i] > 0 && balls[i] <= pl->index) pl->vals[balls[i]-1]++;
 		}
+	}
+}
 
-		/* Side Stacked */
-		if (drawBySide && drawCountDown)
-		{
-			strcpy(label, "(side stacked)");
-			drawnBalls = createListX(drawnBalls, drawBallCount, label, 0, 0, 0, 0, 0);
 
-			if (autoCalc && drawBallCount > 1) {
-				matchComb = 0;
-				elimComb = 2;
-			}
 
-			for (i=0; i < numOfAttempts; i++)
-			{
-				drawnBalls = drawBallBySide(drawnBalls, ballSortOrder, totalBall, drawBallCount, matchComb, elimComb);
+void updateMatchComb(UINTSUM *matchComb, struct TableXY *pt, UINTROW newRows)
+{
+	UINTROW i, j;
+	UINT8 comb, common;
 
-				if (drawBallCount == 1) break;
+	for (i=0; i<newRows; i++)
+	{
+		for (j=i+1; j<pt->rows; j++) 
+		{
+			common = overlapCountT(pt, i, j);
 
-				noMatch = 0;
+			for (comb=2; comb<=common && comb<=DRAW_BALL; comb++) {
+				matchComb[comb-2] += combCount(common, comb);
+			}
+		}
+	}
+}
 
-				if (matchComb == 3) {
-					noMatch = !search3CombXY(luckyBalls3, drawnBalls, NULL);
-				}
 
-				elim = 0;
 
-				switch (elimComb)
-				{
-				case 4 : elim = search4CombXY(luckyBalls4, drawnBalls, foundComb);
-				case 3 : if (!elim) elim = search3CombXY(luckyBalls3, drawnBalls, foundComb);
-				case 2 : if (!elim) elim = search2CombXY(luckyBalls2, drawnBalls, foundComb);
-				default: break;
-				}
+UINT8 updateCombCountList(struct ListXY *pl, struct TableXY *pt, UINTROW newRows, UINT8 comb, UINT8 totalBall)
+{
+	struct CombTable *combTable = NULL;
+	struct CombCount *cc;
+	struct TableXY newTable;
+	struct ListXY updated;
+	struct ListX *nl, *ul, *next;
+	struct ListX *last = NULL;
+	MASKWORD mask[MASK_WORDS];
+	UINT32 i;
+	UINTROW r;
+	UINT8 found;
 
-				if (elim)
-				{
-					fc = foundComb->list;
+	if (newRows == 0) return 1;
 
-					for (k=0; fc && k<lengthY(foundComb); k++) 
-					{
-						dDiff = dateDiff(fc->day, fc->mon, fc->year, currDay, currMon, currYear);
+	/* combinations of the new rows */
+	newTable = *pt;
+	newTable.rows = newRows;
 
-						if (dDiff >= fc->val2 && ((double) fc->val * (double) fc->val2 / (double) drawnDays) >= 0.49) {
-							elim = 0;
-							break;
-						}
-							
-						fc = fc->next;
-					}
-				}
+	combTable = createCombTable(combTable, comb, totalBall, (UINT32) newRows*combCount(pt->cols, comb));
 
-				if (!(noMatch || elim)) {
-					if (i < ceil((double) numOfAttempts/4)) {
-						found = search1BallXY(coupon, drawnBalls, drawBallCount);
-					} else if (i < ceil((double) numOfAttempts/2)) {
-						if (drawBallCount == 1) break;
-						found = search2CombXY(coupon, drawnBalls, NULL);
-					} else if (i < ceil(3* (double) numOfAttempts/4)) {
-						found = search3CombXY(coupon, drawnBalls, NULL);
-					} else {
-						found = search4CombXY(coupon, drawnBalls, NULL);
-					}
+	if (combTable == NULL) return 0;
 
-					if(!found) break;
-				}
+	if (!countCombT(&newTable, combTable)) {
+		removeAllC(combTable);
+		free(combTable);
+		return 0;
+	}
 
-				if (autoCalc && drawBallCount > 1) {
-					if (i < ceil((double) numOfAttempts/4)) {matchComb = 0; elimComb = 2;}
-					else if (i < ceil((double) numOfAttempts/2)) {matchComb = 0; elimComb = 3;}
-					else if (i < ceil(3* (double) numOfAttempts/4)) {matchComb = 3; elimComb = 4;}
-					else {matchComb = 0; elimComb = 0;}
-				}
-			}
+	/* counted again over all rows */
+	for (i=0; i<combTable->size; i++)
+	{
+		cc = &combTable->items[i];
 
-			appendList(coupon, drawnBalls);
-			drawCountDown--;
+		if (cc->count == 0) continue;
 
-			printPercentOfProgress(pLabel, (UINT32) (drawRowCount-drawCountDown), (UINT32) drawRowCount);
-		}
+		setMaskX(mask, cc->balls, comb);
+		cc->count = 0;
 
-		/* Random */
-		if (drawByRand && drawCountDown)
+		for (r=0; r<pt->rows; r++)
 		{
-			strcpy(label, "(random)");
-			drawnBalls = createListX(drawnBalls, drawBallCount, label, 0, 0, 0, 0, 0);
+			if (popCountMask(mask, pt->mask + (UINT32) r*MASK_WORDS) < comb) continue;
 
-			if (autoCalc && drawBallCount > 1) {
-				matchComb = 0;
-				elimComb = 2;
-			}
+			if (cc->count == 0) cc->first = r;
+			else if (cc->count == 1) cc->second = r;
 
-			for (i=0; i < numOfAttempts; i++)
-			{
-				drawnBalls = drawBallByRand(drawnBalls, ballSortOrder, totalBall, drawBallCount, matchComb, elimComb);
+			cc->last = r;
+			if (cc->count < UINTROWMAX) cc->count++;
+		}
+	}
 
-				if (drawBallCount == 1) break;
+	updated.list = NULL;
+	getCombCountList(&updated, combTable, pt);
 
-				noMatch = 0;
+	removeAllC(combTable);
+	free(combTable);
 
-				if (matchComb == 3) {
-					noMatch = !search3CombXY(luckyBalls3, drawnBalls, NULL);
-				}
+	/* 
+	 * The old combinations drawn in a new row are replaced by the updated ones. The others keep their order.
+	 * An updated combination is latest drawn in a new row, so it comes before the old combinations drawn the same times.
+	 */
+	nl = pl->list;
+	ul = updated.list;
+	pl->list = NULL;
 
-				elim = 0;
+	while (nl || ul)
+	{
+		if (nl)
+		{
+			setMaskX(mask, nl->balls, nl->index);
 
-				switch (elimComb)
-				{
-				case 4 : elim = search4CombXY(luckyBalls4, drawnBalls, foundComb);
-				case 3 : if (!elim) elim = search3CombXY(luckyBalls3, drawnBalls, foundComb);
-				case 2 : if (!elim) elim = search2CombXY(luckyBalls2, drawnBalls, foundComb);
-				default: break;
-				}
+			for (r=0, found=0; r<newRows && !found; r++) {
+				found = popCountMask(mask, pt->mask + (UINT32) r*MASK_WORDS) >= nl->index;
+			}
 
-				if (elim)
-				{
-					fc = foundComb->list;
+			if (found) 
+			{
+				next = nl->next;
+				free(nl->balls);
+				if (nl->label) free(nl->label);
+				free(nl);
+				nl = next;
+				continue;
+			}
+		}
 
-					for (k=0; fc && k<lengthY(foundComb); k++) 
-					{
-						dDiff = dateDiff(fc->day, fc->mon, fc->year, currDay, currMon, currYear);
+		if (ul && (nl == NULL || ul->val >= nl->val)) {
+			next = ul;
+			ul = ul->next;
+		} else {
+			next = nl;
+			nl = nl->next;
+		}
 
-						if (dDiff >= fc->val2 && ((double) fc->val * (double) fc->val2 / (double) drawnDays) >= 0.49) {
-							elim = 0;
-							break;
-						}
-							
-						fc = fc->next;
-					}
-				}
+		next->next = NULL;
 
-				if (!(noMatch || elim)) {
-					if (i < ceil((double) numOfAttempts/4)) {
-						found = search1BallXY(coupon, drawnBalls, drawBallCount);
-					} else if (i < ceil((double) numOfAttempts/2)) {
-						if (drawBallCount == 1) break;
-						found = search2CombXY(coupon, drawnBalls, NULL);
-					} else if (i < ceil(3* (double) numOfAttempts/4)) {
-						found = search3CombXY(coupon, drawnBalls, NULL);
-					} else {
-						found = search4CombXY(coupon, drawnBalls, NULL);
-					}
+		if (last) last->next = next;
+		else pl->list = next;
 
-					if(!found) break;
-				}
+		last = next;
+	}
 
-				if (autoCalc && drawBallCount > 1) {
-					if (i < ceil((double) numOfAttempts/4)) {matchComb = 0; elimComb = 2;}
-					else if (i < ceil((double) numOfAttempts/2)) {matchComb = 0; elimComb = 3;}
-					else if (i < ceil(3* (double) numOfAttempts/4)) {matchComb = 3; elimComb = 4;}
-					else {matchComb = 0; elimComb = 0;}
-				}
-			}
+	return 1;
+}
 
-			appendList(coupon, drawnBalls);
-			drawCountDown--;
 
-			printPercentOfProgress(pLabel, (UINT32) (drawRowCount-drawCountDown), (UINT32) drawRowCount);
-		}
 
-		/* Lucky */
-		if (drawByLucky && drawCountDown)
-		{
-			if (drawBallCount > 1) // winning numbers
-			{
-				luckyNum = (j%3)+1;
 
-				if (luckyNum == 1) strcpy(label, "(lucky 3)");
-				else if (luckyNum == 2) strcpy(label, "(2 of lucky 3)");
-				else strcpy(label, "(lucky 2)");
+UINT8 saveSnapshot(char *fileName)
+{
+	struct SnapshotHeader header;
+	char snapFile[PATH_MAX];
+	UINTSUM matchComb[DRAW_BALL-1];
+	UINT32 magic;
+	UINT8 ok;
+	FILE *fp;
 
-				drawnBalls = createListX(drawnBalls, drawBallCount, label, 0, 0, 0, 0, 0);
-    	        drawnBalls = drawBallsByLucky(drawnBalls, luckyNum, totalBall, drawBallCount);
-			}
-			else // plusNumber
-			{
-				strcpy(label, "plus number");
-				drawnBalls = createListX(drawnBalls, drawBallCount, label, 0, 0, 0, 0, 0);
+	if (strlen(fileName) + strlen(SNAPSHOTEXT) >= PATH_MAX) return 0;
 
-				for (i=0; i < numOfAttempts; i++) 
-				{
-					if (i < ceil((double) numOfAttempts/4)) {
-    					if (j%2 == 0) drawnBalls = drawBallByNorm(drawnBalls, ballSortOrder, totalBall, drawBallCount, 0, 0);
-						else drawnBalls = drawBallByLeft(drawnBalls, ballSortOrder, totalBall, drawBallCount, 0, 0);
-					} else if (i < ceil((double) numOfAttempts/2)) {
-    					if (j%2 == 0) drawnBalls = drawBallByBlend1(drawnBalls, ballSortOrder, totalBall, drawBallCount, 0, 0);
-						else drawnBalls = drawBallByBlend2(drawnBalls, ballSortOrder, totalBall, drawBallCount, 0, 0);
-					} else if (i < ceil(3* (double) numOfAttempts/4)) {
-    					drawnBalls = drawBallBySide(drawnBalls, ballSortOrder, totalBall, drawBallCount, 0, 0);
-					} else {
-    					drawnBalls = drawBallByRand(drawnBalls, ballSortOrder, totalBall, drawBallCount, 0, 0);
-					}
+	strcpy(snapFile, fileName);
+	strcat(snapFile, SNAPSHOTEXT);
 
-					if (lengthY(coupon) > ceil(1.25*totalBall/drawBallCount)) break;
-    				found = search1BallXY(coupon, drawnBalls, drawBallCount);
-					if(!found) break;
-				}
-			}
+	if (!getSnapshotHeader(fileName, &header)) return 0;
 
-			appendList(coupon, drawnBalls);
-			drawCountDown--;
+	if ((fp = fopen(snapFile, "wb")) == NULL) return 0;
 
-			printPercentOfProgress(pLabel, (UINT32) (drawRowCount-drawCountDown), (UINT32) drawRowCount);
-		}
+	matchComb[0] = match2comb;
+	matchComb[1] = match3comb;
+	matchComb[2] = match4comb;
+	matchComb[3] = match5comb;
+
+	magic = header.magic;
+	header.magic = 0;
+
+	ok = fwrite(&header, sizeof(struct SnapshotHeader), 1, fp) == 1
+		&& saveTableT(fp, winningDrawnBallsList)
+		&& saveTableT(fp, plusNumberDrawnBallsList)
+		&& saveListX2(fp, winningBallsDrawCount)
+		&& saveListX2(fp, plusNumberBallsDrawCount)
+		&& saveListXY(fp, luckyBalls2)
+		&& saveListXY(fp, luckyBalls3)
+		&& saveListXY(fp, luckyBalls4)
+		&& fwrite(matchComb, sizeof(UINTSUM), DRAW_BALL-1, fp) == DRAW_BALL-1;
+
+	if (ok) 
+	{
+		header.magic = magic;
+		ok = fseek(fp, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(struct SnapshotHeader), 1, fp) == 1;
 	}
+
+	if (fclose(fp) != 0) ok = 0;
+	if (!ok) remove(snapFile);
+
+	return ok;
 }
 
 
 
-UINT16 getDrawnBallsList(struct ListXY *ballList, char *fileName)
+UINT8 loadSnapshot(char *fileName)
 {
-	UINT16 i=0;
-	int d1, m1, y1, pn;
-	int n1, n2, n3, n4, n5;
-	UINT8 keys[DRAW_BALL+1];
-	UINT8 size;
-	char ioBuf[50];
+	struct SnapshotHeader header, snapHeader;
+	struct TableXY *oldWinningDrawnBallsList = NULL;
+	struct TableXY *oldPlusNumberDrawnBallsList = NULL;
+	char snapFile[PATH_MAX];
+	UINTSUM matchComb[DRAW_BALL-1];
+	UINT32 length;
+	SINT32 newWinningRows = 0, newPNumberBallRows = 0;
+	char *buf, *pos, *end;
+	UINT8 ok, update;
 
-	FILE *fp;
+	if (strlen(fileName) + strlen(SNAPSHOTEXT) >= PATH_MAX) return 0;
 
-	struct ListX *drawList = NULL;
+	strcpy(snapFile, fileName);
+	strcat(snapFile, SNAPSHOTEXT);
+
+	if ((buf = mapFile(snapFile, &length)) == NULL) return 0;
 
-	if ((fp = fopen(fileName, "r")) == NULL) {
+	pos = buf;
+	end = buf + length;
+
+	if (!readBytes(&pos, end, &snapHeader, sizeof(struct SnapshotHeader)) || snapHeader.magic != SNAPSHOTMAGIC
+		|| !getSnapshotHeader(fileName, &header) || snapHeader.version != header.version || snapHeader.layout != header.layout) 
+	{
+		unmapFile(buf, length);
 		return 0;
 	}
 
-	for (i=0; fgets(ioBuf, 50, fp) && i<UINT16MAX; i++)
+	/* statistics file is changed, the draws in the snapshot must be the last rows of it */
+	update = memcmp(&header, &snapHeader, sizeof(struct SnapshotHeader)) != 0;
+
+	if (update) 
 	{
-		sscanf(ioBuf, "%d.%d.%d\t%d\t%d\t%d\t%d\t%d\t%d\n", &d1, &m1, &y1, &n1, &n2, &n3, &n4, &n5, &pn);
+		oldWinningDrawnBallsList = createTableXY(oldWinningDrawnBallsList, DRAW_BALL, 512);
+		oldPlusNumberDrawnBallsList = createTableXY(oldPlusNumberDrawnBallsList, 1, 512);
+
+		ok = loadTableT(&pos, end, oldWinningDrawnBallsList)
+			&& loadTableT(&pos, end, oldPlusNumberDrawnBallsList)
+			&& (winningBallRows = getDrawnBallsList(winningDrawnBallsList, plusNumberDrawnBallsList, fileName)) > 0
+			&& (pNumberBallRows = plusNumberDrawnBallsList->rows) > 0
+			&& (newWinningRows = newRowsT(winningDrawnBallsList, oldWinningDrawnBallsList)) >= 0
+			&& (newPNumberBallRows = newRowsT(plusNumberDrawnBallsList, oldPlusNumberDrawnBallsList)) >= 0;
+
+		removeAllT(oldWinningDrawnBallsList);
+		free(oldWinningDrawnBallsList);
+		removeAllT(oldPlusNumberDrawnBallsList);
+		free(oldPlusNumberDrawnBallsList);
+	} else {
+		ok = loadTableT(&pos, end, winningDrawnBallsList)
+			&& loadTableT(&pos, end, plusNumberDrawnBallsList);
+	}
 
-		if (ballList == winningDrawnBallsList) {
-			keys[0] = (UINT8) n1;
-			keys[1] = (UINT8) n2;
-			keys[2] = (UINT8) n3;
-			keys[3] = (UINT8) n4;
-			keys[4] = (UINT8) n5;
-			keys[5] = '\0';
-			size = DRAW_BALL;
-		} else if (ballList == plusNumberDrawnBallsList) {
-			keys[0] = (UINT8) pn;
-			keys[1] = '\0';
-			size = 1;
-		}
-		drawList = createListX(drawList, size, NULL, 0, 0, (UINT16) y1, (UINT8) m1, (UINT8) d1);
+	ok = ok
+		&& loadListX2(&pos, end, winningBallsDrawCount)
+		&& loadListX2(&pos, end, plusNumberBallsDrawCount)
+		&& loadListXY(&pos, end, luckyBalls2)
+		&& loadListXY(&pos, end, luckyBalls3)
+		&& loadListXY(&pos, end, luckyBalls4)
+		&& readBytes(&pos, end, matchComb, sizeof(UINTSUM)*(DRAW_BALL-1))
+		&& pos == end;
 
-		appendItems(drawList, keys);
-		appendList(ballList, drawList);
+	unmapFile(buf, length);
+
+	if (ok && update) 
+	{
+		updateBallCountX2(winningBallsDrawCount, winningDrawnBallsList, (UINTROW) newWinningRows);
+		updateBallCountX2(plusNumberBallsDrawCount, plusNumberDrawnBallsList, (UINTROW) newPNumberBallRows);
+		updateMatchComb(matchComb, winningDrawnBallsList, (UINTROW) newWinningRows);
+
+		ok = updateCombCountList(luckyBalls2, winningDrawnBallsList, (UINTROW) newWinningRows, 2, TOTAL_BALL)
+			&& updateCombCountList(luckyBalls3, winningDrawnBallsList, (UINTROW) newWinningRows, 3, TOTAL_BALL)
+			&& updateCombCountList(luckyBalls4, winningDrawnBallsList, (UINTROW) newWinningRows, 4, TOTAL_BALL);
 	}
 
-	fclose(fp);
+	if (!ok) 
+	{
+		winningDrawnBallsList->rows = 0;
+		plusNumberDrawnBallsList->rows = 0;
+		removeAllX2(winningBallsDrawCount);
+		removeAllX2(plusNumberBallsDrawCount);
+		removeAllXY(luckyBalls2);
+		removeAllXY(luckyBalls3);
+		removeAllXY(luckyBalls4);
+		return 0;
+	}
 
-	return i;
+	winningBallRows = winningDrawnBallsList->rows;
+	pNumberBallRows = plusNumberDrawnBallsList->rows;
+
+	match2comb = matchComb[0];
+	match3comb = matchComb[1];
+	match4comb = matchComb[2];
+	match5comb = matchComb[3];
+
+	if (update) saveSnapshot(fileName);
+
+	return 1;
 }
 
+#endif
+
+
 
 
-UINT16 dateDiff(UINT8 d1, UINT8 m1, UINT16 y1, UINT8 d2, UINT8 m2, UINT16 y2)
+UINTDAY dateDiff(UINT8 d1, UINT8 m1, UINT16 y1, UINT8 d2, UINT8 m2, UINT16 y2)
 {
-	UINT16 x1, x2;
+	return (UINTDAY) (getEpochDay(d2, m2, y2) - getEpochDay(d1, m1, y1));
+}
+
 
-	m1 = (m1 + 9) % 12;
-	y1 = y1 - m1 / 10;
-	x1 = 365*y1 + y1/4 - y1/100 + y1/400 + (m1*306 + 5)/10 + (d1-1);
 
-	m2 = (m2 + 9) % 12;
-	y2 = y2 - m2 / 10;
-	x2 = 365*y2 + y2/4 - y2/100 + y2/400 + (m2*306 + 5)/10 + (d2-1);
+UINT32 getEpochDay(UINT8 day, UINT8 mon, UINT16 year)
+{
+	mon = (mon + 9) % 12;
+	year = year - mon / 10;
 
-	return (x2-x1);
+	return 365*(UINT32) year + year/4 - year/100 + year/400 + (mon*306 + 5)/10 + (day-1);
 }
 
 
@@ -4180,20 +9236,15 @@ struct ListX * drawBallByRand(struct ListX *drawnBallsRand, struct ListX2 *ballS
 	UINT8 flyball, drawball;
 	UINT16 shuffleGlobe;
 	UINT8 noMatch, elim;
-	UINT16 dDiff;
 
 	struct ListX2 *globe = NULL;
-	struct ListX *fc = NULL;
-	struct ListXY *foundComb = NULL;
-
-	foundComb = createListXY(foundComb);
 
 	globe = createListX2(globe, totalBall);
 
 	bubbleSortX2ByVal(ballSortOrder, 1);
 
 	/* Fill inside the globe with balls */
-	if (rand() % 2) // (blend1)
+	if (randomBelow(&rng, 2)) // (blend1)
 	{
 		for (x=0, j=totalBall-1, k=0; k<totalBall; k++)
 		{
@@ -4229,11 +9280,11 @@ struct ListX * drawBallByRand(struct ListX *drawnBallsRand, struct ListX2 *ballS
 		for (j=0; j<drawBallCount; j++)
 		{
 			/* shuffle globe */
-			shuffleGlobe = (UINT16) ((ceil(totalBall/drawBallCount) * (rand() % 6 + (UINT16) ceil(totalBall/2) - 5) * (rand() % 6 + (UINT16) ceil(totalBall/3) - 5)));
+			shuffleGlobe = (UINT16) ((ceil(totalBall/drawBallCount) * (randomBelow(&rng, 6) + (UINT16) ceil(totalBall/2) - 5) * (randomBelow(&rng, 6) + (UINT16) ceil(totalBall/3) - 5)));
 
 			for (k=0; k<shuffleGlobe; k++)
 			{
-				index = rand() % (totalBall-j);
+				index = randomBelow(&rng, totalBall-j);
 
 				flyball = removeItemByIndex2(globe, index);
 
@@ -4273,35 +9324,10 @@ struct ListX * drawBallByRand(struct ListX *drawnBallsRand, struct ListX2 *ballS
 		noMatch = 0;
 
 		if (matchComb == 3) {
-			noMatch = !search3CombXY(luckyBalls3, drawnBallsRand, NULL);
-		}
-
-		elim = 0;
-
-		switch (elimComb)
-		{
-		case 4 : elim = search4CombXY(luckyBalls4, drawnBallsRand, foundComb);
-		case 3 : if (!elim) elim = search3CombXY(luckyBalls3, drawnBallsRand, foundComb);
-		case 2 : if (!elim) elim = search2CombXY(luckyBalls2, drawnBallsRand, foundComb);
-		default: break;
+			noMatch = !searchLucky(drawnBallsRand, 3, NULL);
 		}
 
-		if (elim)
-		{
-			fc = foundComb->list;
-
-			for (x=0; fc && x<lengthY(foundComb); x++) 
-			{
-				dDiff = dateDiff(fc->day, fc->mon, fc->year, currDay, currMon, currYear);
-
-				if (dDiff >= fc->val2 && ((double) fc->val * (double) fc->val2 / (double) drawnDays) >= 0.49) {
-					elim = 0;
-					break;
-				}
-							
-				fc = fc->next;
-			}
-		}
+		elim = elimByLucky(drawnBallsRand, elimComb);
 
 		if (!(noMatch || elim)) break;
 	}
@@ -4320,13 +9346,8 @@ struct ListX * drawBallByLeft(struct ListX *drawnBallsLeft, struct ListX2 *ballS
 	UINT8 i, k;
 	UINT8 noMatch, elim;
 	UINT8 drawball;
-	UINT16 dDiff;
 
 	struct ListX2 *globe = NULL;
-	struct ListX *fc = NULL;
-	struct ListXY *foundComb = NULL;
-
-	foundComb = createListXY(foundComb);
 
 	globe = createListX2(globe, totalBall);
 
@@ -4354,35 +9375,10 @@ struct ListX * drawBallByLeft(struct ListX *drawnBallsLeft, struct ListX2 *ballS
 		noMatch = 0;
 
 		if (matchComb == 3) {
-			noMatch = !search3CombXY(luckyBalls3, drawnBallsLeft, NULL);
-		}
-
-		elim = 0;
-
-		switch (elimComb)
-		{
-		case 4 : elim = search4CombXY(luckyBalls4, drawnBallsLeft, foundComb);
-		case 3 : if (!elim) elim = search3CombXY(luckyBalls3, drawnBallsLeft, foundComb);
-		case 2 : if (!elim) elim = search2CombXY(luckyBalls2, drawnBallsLeft, foundComb);
-		default: break;
+			noMatch = !searchLucky(drawnBallsLeft, 3, NULL);
 		}
 
-		if (elim)
-		{
-			fc = foundComb->list;
-
-			for (i=0; fc && i<lengthY(foundComb); i++) 
-			{
-				dDiff = dateDiff(fc->day, fc->mon, fc->year, currDay, currMon, currYear);
-
-				if (dDiff >= fc->val2 && ((double) fc->val * (double) fc->val2 / (double) drawnDays) >= 0.49) {
-					elim = 0;
-					break;
-				}
-							
-				fc = fc->next;
-			}
-		}
+		elim = elimByLucky(drawnBallsLeft, elimComb);
 
 		if (!(noMatch || elim)) break;
 	}
@@ -4401,13 +9397,8 @@ struct ListX * drawBallByBlend1(struct ListX *drawnBallsBlend1, struct ListX2 *b
 	UINT8 i, j, k;
 	UINT8 noMatch, elim;
 	UINT8 drawball;
-	UINT16 dDiff;
 
 	struct ListX2 *globe = NULL;
-	struct ListX *fc = NULL;
-	struct ListXY *foundComb = NULL;
-
-	foundComb = createListXY(foundComb);
 
 	globe = createListX2(globe, totalBall);
 
@@ -4443,35 +9434,10 @@ struct ListX * drawBallByBlend1(struct ListX *drawnBallsBlend1, struct ListX2 *b
 		noMatch = 0;
 
 		if (matchComb == 3) {
-			noMatch = !search3CombXY(luckyBalls3, drawnBallsBlend1, NULL);
-		}
-
-		elim = 0;
-
-		switch (elimComb)
-		{
-		case 4 : elim = search4CombXY(luckyBalls4, drawnBallsBlend1, foundComb);
-		case 3 : if (!elim) elim = search3CombXY(luckyBalls3, drawnBallsBlend1, foundComb);
-		case 2 : if (!elim) elim = search2CombXY(luckyBalls2, drawnBallsBlend1, foundComb);
-		default: break;
+			noMatch = !searchLucky(drawnBallsBlend1, 3, NULL);
 		}
 
-		if (elim)
-		{
-			fc = foundComb->list;
-
-			for (i=0; fc && i<lengthY(foundComb); i++) 
-			{
-				dDiff = dateDiff(fc->day, fc->mon, fc->year, currDay, currMon, currYear);
-
-				if (dDiff >= fc->val2 && ((double) fc->val * (double) fc->val2 / (double) drawnDays) >= 0.49) {
-					elim = 0;
-					break;
-				}
-							
-				fc = fc->next;
-			}
-		}
+		elim = elimByLucky(drawnBallsBlend1, elimComb);
 
 		if (!(noMatch || elim)) break;
 	}
@@ -4490,13 +9456,8 @@ struct ListX * drawBallByBlend2(struct ListX *drawnBallsBlend2, struct ListX2 *b
 	UINT8 i, j, k;
 	UINT8 noMatch, elim;
 	UINT8 drawball;
-	UINT16 dDiff;
 
 	struct ListX2 *globe = NULL;
-	struct ListX *fc = NULL;
-	struct ListXY *foundComb = NULL;
-
-	foundComb = createListXY(foundComb);
 
 	globe = createListX2(globe, totalBall);
 
@@ -4532,35 +9493,10 @@ struct ListX * drawBallByBlend2(struct ListX *drawnBallsBlend2, struct ListX2 *b
 		noMatch = 0;
 
 		if (matchComb == 3) {
-			noMatch = !search3CombXY(luckyBalls3, drawnBallsBlend2, NULL);
-		}
-
-		elim = 0;
-
-		switch (elimComb)
-		{
-		case 4 : elim = search4CombXY(luckyBalls4, drawnBallsBlend2, foundComb);
-		case 3 : if (!elim) elim = search3CombXY(luckyBalls3, drawnBallsBlend2, foundComb);
-		case 2 : if (!elim) elim = search2CombXY(luckyBalls2, drawnBallsBlend2, foundComb);
-		default: break;
+			noMatch = !searchLucky(drawnBallsBlend2, 3, NULL);
 		}
 
-		if (elim)
-		{
-			fc = foundComb->list;
-
-			for (i=0; fc && i<lengthY(foundComb); i++) 
-			{
-				dDiff = dateDiff(fc->day, fc->mon, fc->year, currDay, currMon, currYear);
-
-				if (dDiff >= fc->val2 && ((double) fc->val * (double) fc->val2 / (double) drawnDays) >= 0.49) {
-					elim = 0;
-					break;
-				}
-							
-				fc = fc->next;
-			}
-		}
+		elim = elimByLucky(drawnBallsBlend2, elimComb);
 
 		if (!(noMatch || elim)) break;
 	}
@@ -4579,13 +9515,8 @@ struct ListX * drawBallBySide(struct ListX *drawnBallsSide, struct ListX2 *ballS
 	UINT8 i, k;
 	UINT8 noMatch, elim;
 	UINT8 drawball;
-	UINT16 dDiff;
 
 	struct ListX2 *globe = NULL;
-	struct ListX *fc = NULL;
-	struct ListXY *foundComb = NULL;
-
-	foundComb = createListXY(foundComb);
 
 	globe = createListX2(globe, totalBall);
 
@@ -4619,35 +9550,10 @@ struct ListX * drawBallBySide(struct ListX *drawnBallsSide, struct ListX2 *ballS
 		noMatch = 0;
 
 		if (matchComb == 3) {
-			noMatch = !search3CombXY(luckyBalls3, drawnBallsSide, NULL);
-		}
-
-		elim = 0;
-
-		switch (elimComb)
-		{
-		case 4 : elim = search4CombXY(luckyBalls4, drawnBallsSide, foundComb);
-		case 3 : if (!elim) elim = search3CombXY(luckyBalls3, drawnBallsSide, foundComb);
-		case 2 : if (!elim) elim = search2CombXY(luckyBalls2, drawnBallsSide, foundComb);
-		default: break;
+			noMatch = !searchLucky(drawnBallsSide, 3, NULL);
 		}
 
-		if (elim)
-		{
-			fc = foundComb->list;
-
-			for (i=0; fc && i<lengthY(foundComb); i++) 
-			{
-				dDiff = dateDiff(fc->day, fc->mon, fc->year, currDay, currMon, currYear);
-
-				if (dDiff >= fc->val2 && ((double) fc->val * (double) fc->val2 / (double) drawnDays) >= 0.49) {
-					elim = 0;
-					break;
-				}
-							
-				fc = fc->next;
-			}
-		}
+		elim = elimByLucky(drawnBallsSide, elimComb);
 
 		if (!(noMatch || elim)) break;
 	}
@@ -4666,13 +9572,8 @@ struct ListX * drawBallByNorm(struct ListX *drawnBallsNorm, struct ListX2 *ballS
 	UINT8 i, k;
 	UINT8 noMatch, elim;
 	UINT8 drawball;
-	UINT16 dDiff;
 
 	struct ListX2 *globe = NULL;
-	struct ListX *fc = NULL;
-	struct ListXY *foundComb = NULL;
-
-	foundComb = createListXY(foundComb);
 
 	globe = createListX2(globe, totalBall);
 
@@ -4706,35 +9607,10 @@ struct ListX * drawBallByNorm(struct ListX *drawnBallsNorm, struct ListX2 *ballS
 		noMatch = 0;
 
 		if (matchComb == 3) {
-			noMatch = !search3CombXY(luckyBalls3, drawnBallsNorm, NULL);
-		}
-
-		elim = 0;
-
-		switch (elimComb)
-		{
-		case 4 : elim = search4CombXY(luckyBalls4, drawnBallsNorm, foundComb);
-		case 3 : if (!elim) elim = search3CombXY(luckyBalls3, drawnBallsNorm, foundComb);
-		case 2 : if (!elim) elim = search2CombXY(luckyBalls2, drawnBallsNorm, foundComb);
-		default: break;
+			noMatch = !searchLucky(drawnBallsNorm, 3, NULL);
 		}
 
-		if (elim)
-		{
-			fc = foundComb->list;
-
-			for (i=0; fc && i<lengthY(foundComb); i++) 
-			{
-				dDiff = dateDiff(fc->day, fc->mon, fc->year, currDay, currMon, currYear);
-
-				if (dDiff >= fc->val2 && ((double) fc->val * (double) fc->val2 / (double) drawnDays) >= 0.49) {
-					elim = 0;
-					break;
-				}
-							
-				fc = fc->next;
-			}
-		}
+		elim = elimByLucky(drawnBallsNorm, elimComb);
 
 		if (!(noMatch || elim)) break;
 	}
@@ -4753,7 +9629,7 @@ void getDrawnBallCount()
 /* readable code but very fast code below
 
 	UINT8 i;
-	UINT16 j;
+	UINTROW j;
 	UINT8 n1, n2, n3, n4, n5, pn;
 	UINT8 keys[DRAW_BALL+1];
 	int index;
@@ -4798,9 +9674,9 @@ void getDrawnBallCount()
 */
 
 	UINT8 i;
-	UINT16 j;
+	UINTROW j;
 
-	struct ListX *aPrvDrawn = NULL;
+	UINT8 *balls;
 
 	for (i=0; i<TOTAL_BALL; i++) 
 	{
@@ -4812,17 +9688,15 @@ void getDrawnBallCount()
 		}
 	}
 
-	aPrvDrawn = winningDrawnBallsList->list;
-
-	for (j=0; (aPrvDrawn) && j<winningBallRows; j++) 
+	for (j=0; j<winningBallRows; j++) 
 	{
-		winningBallsDrawCount->vals[aPrvDrawn->balls[0]-1]++;
-		winningBallsDrawCount->vals[aPrvDrawn->balls[1]-1]++;
-		winningBallsDrawCount->vals[aPrvDrawn->balls[2]-1]++;
-		winningBallsDrawCount->vals[aPrvDrawn->balls[3]-1]++;
-		winningBallsDrawCount->vals[aPrvDrawn->balls[4]-1]++;
-		
-		aPrvDrawn = aPrvDrawn->next;
+		balls = getRowT(winningDrawnBallsList, j);
+
+		winningBallsDrawCount->vals[balls[0]-1]++;
+		winningBallsDrawCount->vals[balls[1]-1]++;
+		winningBallsDrawCount->vals[balls[2]-1]++;
+		winningBallsDrawCount->vals[balls[3]-1]++;
+		winningBallsDrawCount->vals[balls[4]-1]++;
 	}
 	
 	for (i=0; i<TOTAL_BALL_PN; i++) 
@@ -4835,13 +9709,11 @@ void getDrawnBallCount()
 		}
 	}
 
-	aPrvDrawn = plusNumberDrawnBallsList->list;
-
-	for (j=0; (aPrvDrawn) && j<pNumberBallRows; j++) 
+	for (j=0; j<pNumberBallRows; j++) 
 	{
-		plusNumberBallsDrawCount->vals[aPrvDrawn->balls[0]-1]++;
-		
-		aPrvDrawn = aPrvDrawn->next;
+		balls = getRowT(plusNumberDrawnBallsList, j);
+
+		plusNumberBallsDrawCount->vals[balls[0]-1]++;
 	}
 }
 
@@ -4864,11 +9736,18 @@ void printPercentOfProgress(char *label, UINT32 completed, UINT32 all)
 {
 #if defined(__MSDOS__)
 	union REGS regs;
+#elif defined(WIN32)
+	HANDLE handle;
+	CONSOLE_CURSOR_INFO cci;
+#endif
+
+	if (!showProgress) return;
+
+#if defined(__MSDOS__)
 	regs.x.ax = 2;
 	int86(0x33, &regs, &regs);
 #elif defined(WIN32)
-	HANDLE handle = GetStdHandle(STD_OUTPUT_HANDLE);
-	CONSOLE_CURSOR_INFO cci;
+	handle = GetStdHandle(STD_OUTPUT_HANDLE);
 	GetConsoleCursorInfo(handle, &cci);
 	cci.bVisible = 0;
 	SetConsoleCursorInfo(handle, &cci);
@@ -5001,7 +9880,7 @@ UINT8 isIntString(char* input)
 
 
 
-int main(void)
+int main(int argc, char *argv[])
 {
 	struct ListXY *coupon = NULL;
 	struct ListXY *coupon_pn = NULL;
@@ -5009,8 +9888,97 @@ int main(void)
 
 	char input[100], *endptr;
 	UINT16 keyb = 0, keyb2;
+	UINT16 couponDraws = 0;
+	UINT32 largeRows = 0;
+	UINT8 largeToStdout = 0;
+	UINT32 topCount = 0;
+	char *ticketsFile = NULL;
+	UINTROW backtestCount = 0;
+	UINTROW first, last;
+	char *window = NULL;
+	UINT8 queryBalls[DRAW_BALL];
+	UINT8 queryCount = 0;
+	UINT32 nearDays = 0;
+	UINT8 nearOverlap = 0;
+	UINT32 simulateCount = 0;
+	UINT8 modes;
+	int i;
+	#ifdef USE_THREADS
+	long threads;
+	#endif
+
+	randomSeed = (UINT32) time(NULL);
+
+	for (i=1; i<argc; i++) {
+		if (strcmp(argv[i], "--seed") == 0 && i+1 < argc && isIntString(argv[i+1])) {
+			randomSeed = (UINT32) strtoul(argv[++i], NULL, 10);
+		}
+		#ifndef __MSDOS__
+		else if (strcmp(argv[i], "--rows") == 0 && i+1 < argc && isIntString(argv[i+1]) && strtoul(argv[i+1], NULL, 10) > 0) {
+			largeRows = (UINT32) strtoul(argv[++i], NULL, 10);
+		}
+		else if (strcmp(argv[i], "--top") == 0 && i+1 < argc && isIntString(argv[i+1]) && strtoul(argv[i+1], NULL, 10) > 0) {
+			topCount = (UINT32) strtoul(argv[++i], NULL, 10);
+			if (topCount > TOPMAX) topCount = TOPMAX;
+		}
+		else if (strcmp(argv[i], "--score") == 0 && i+1 < argc) {
+			ticketsFile = argv[++i];
+		}
+		else if (strcmp(argv[i], "--backtest") == 0 && i+1 < argc && isIntString(argv[i+1]) && strtoul(argv[i+1], NULL, 10) > 0) {
+			backtestCount = (strtoul(argv[i+1], NULL, 10) > UINTROWMAX) ? UINTROWMAX : (UINTROW) strtoul(argv[i+1], NULL, 10);
+			i++;
+		}
+		else if (strcmp(argv[i], "--query") == 0 && i+1 < argc && (queryCount = getQueryBalls(argv[i+1], queryBalls)) > 0) {
+			i++;
+		}
+		else if (strcmp(argv[i], "--near") == 0 && i+1 < argc && isIntString(argv[i+1]) && strtoul(argv[i+1], NULL, 10) > 0) {
+			nearDays = (UINT32) strtoul(argv[++i], NULL, 10);
+		}
+		else if (strcmp(argv[i], "--overlap") == 0 && i+1 < argc && isIntString(argv[i+1]) && strtoul(argv[i+1], NULL, 10) >= 2 && strtoul(argv[i+1], NULL, 10) <= DRAW_BALL) {
+			nearOverlap = (UINT8) strtoul(argv[++i], NULL, 10);
+		}
+		else if (strcmp(argv[i], "--simulate") == 0 && i+1 < argc && isIntString(argv[i+1]) && strtoul(argv[i+1], NULL, 10) > 0) {
+			simulateCount = (strtoul(argv[i+1], NULL, 10) > SIMMAX) ? SIMMAX : (UINT32) strtoul(argv[i+1], NULL, 10);
+			i++;
+		}
+		else if (strcmp(argv[i], "--window") == 0 && i+1 < argc) {
+			window = argv[++i];
+		}
+		else if (strcmp(argv[i], "--stdout") == 0) {
+			largeToStdout = 1;
+		}
+		#endif
+		#ifdef USE_THREADS
+		else if (strcmp(argv[i], "--threads") == 0 && i+1 < argc && isIntString(argv[i+1])) {
+			threads = strtoul(argv[++i], NULL, 10);
+			if (threads == 0) threads = sysconf(_SC_NPROCESSORS_ONLN);
+			drawThreads = (threads < 1) ? 1 : (threads > 64) ? 64 : (UINT8) threads;
+		}
+		#endif
+		else {
+			#if defined(USE_THREADS)
+			printf("usage: %s [--seed number] [--threads number] [--window draws|years] [--rows number | --top number | --score file | --backtest number | --query numbers | --near days [--overlap number] | --simulate number] [--stdout]\n", argv[0]);
+			#elif !defined(__MSDOS__)
+			printf("usage: %s [--seed number] [--window draws|years] [--rows number | --top number | --score file | --backtest number | --query numbers | --near days [--overlap number] | --simulate number] [--stdout]\n", argv[0]);
+			#else
+			printf("usage: %s [--seed number]\n", argv[0]);
+			#endif
+			return -1;
+		}
+	}
+
+	/* the options that run without the menu are exclusive */
+	modes = (largeRows > 0) + (topCount > 0) + (ticketsFile != NULL) + (backtestCount > 0) + (queryCount > 0) + (nearDays > 0) + (simulateCount > 0);
+
+	if ((largeToStdout && modes == 0) || modes > 1 || (nearOverlap && !nearDays)) {
+		printf("usage: %s [--seed number] [--window draws|years] [--rows number | --top number | --score file | --backtest number | --query numbers | --near days [--overlap number] | --simulate number] [--stdout]\n", argv[0]);
+		return -1;
+	}
+
+	seedRandom(&rng, randomSeed, 0);
 
-	srand((unsigned) time(NULL));
+	/* keep the streamed coupon free of console messages */
+	if (largeToStdout) showProgress = 0;
 
 	if (!init()) {
 		puts("Initialization failed!\n");
@@ -5018,9 +9986,61 @@ int main(void)
 		return -1;
 	}
 
+	#ifndef __MSDOS__
+	if (window && !getWindowRows(window, &first, &last)) {
+		printf("There are no draws in the window %s\n", window);
+		return -1;
+	}
+
+	if (window && !setStatsWindow(first, last)) {
+		puts("There is not enough memory for the statistics of the window!");
+		return -1;
+	}
+
+	/* the lucky numbers of the years are due by the latest draw of the years, not by today */
+	if (window && !isIntString(window)) currEpochDay = winningDrawnBallsList->epochDay[windowFirst];
+	#endif
+
+	if (modes)
+	{
+		if (largeToStdout) {
+			fp = stdout;
+		} else if ((fp = fopen(outputFile, "w")) == NULL) {
+			printf("Can't open file %s\n", OUTPUTFILE);
+			return -1;
+		} else {
+			if (largeRows) printf("%lu rows are writing to %s file...\n", (unsigned long) largeRows, OUTPUTFILE);
+			else if (topCount) printf("%lu tickets are writing to %s file...\n", (unsigned long) topCount, OUTPUTFILE);
+			else if (ticketsFile) printf("Scores of the tickets in %s are writing to %s file...\n", ticketsFile, OUTPUTFILE);
+			else if (backtestCount) printf("Backtest is writing to %s file...\n", OUTPUTFILE);
+			else if (queryCount) printf("Draws that contain the numbers are writing to %s file...\n", OUTPUTFILE);
+			else if (nearDays) printf("Near-duplicate draws are writing to %s file...\n", OUTPUTFILE);
+			else printf("Monte Carlo test is writing to %s file...\n", OUTPUTFILE);
+		}
+
+		if (largeRows) drawLargeCoupon(largeRows, fp);
+		else if (topCount) searchTopTickets(topCount, fp);
+		else if (ticketsFile) {
+			if (scoreTicketsFile(ticketsFile, fp) == 0) printf("There is no ticket in %s\n", ticketsFile);
+		}
+		else if (backtestCount) backtest(backtestCount, fp);
+		else if (queryCount) queryDraws(queryBalls, queryCount, 2, fp);
+		else if (nearDays) nearDuplicates(nearDays, nearOverlap ? nearOverlap : NEAROVERLAP, fp);
+		else monteCarlo(simulateCount, fp);
+
+		if (fp != stdout) fclose(fp);
+
+		return 0;
+	}
+
 	coupon = createListXY(coupon);
 	coupon_pn = createListXY(coupon_pn);
 
+	#ifndef __MSDOS__
+	coupon->couponIndex = createCouponIndex(coupon->couponIndex, TOTAL_BALL, DRAW_BALL);
+	coupon_pn->couponIndex = createCouponIndex(coupon_pn->couponIndex, TOTAL_BALL_PN, 1);
+	#endif
+
 mainMenu:
 
 	puts("SansTopu Lotto 2.0 Copyright ibrahim Tipirdamaz (c) 2023\n");
@@ -5065,7 +10085,13 @@ mainMenu:
 	#else
 	printf("\n");
 	#endif
-	printf("9- Exit\n");
+	printf("9- Exit");
+	#ifdef __MSDOS__
+	gotoxy(41, wherey()+1);
+	#else
+	printf("\n");
+	#endif
+	printf("10- Draws that contain the numbers\n");
 	printf("\nPlease input your selection and press enter: ");
 
 keybCommand:
@@ -5073,7 +10099,7 @@ keybCommand:
 	do {
 		scanf("%s",input);
 		keyb = strtod(input, &endptr);
-		if (isIntString(input) && (keyb >= 0 && keyb < 10)) {
+		if (isIntString(input) && (keyb >= 0 && keyb < 11)) {
 			break;
 		} else {
 			printf("incorrect input!\n");
@@ -5111,14 +10137,20 @@ keybCommand:
 
 		puts("");
 
+		couponDraws++;
+
 		/* coupon, totalBall, drawBallCount, drawRowCount, drawByNorm, left, blend1, blend2, side, rand, lucky */
 		drawBalls(coupon, TOTAL_BALL, DRAW_BALL, keyb2, 1, 1, 1, 1, 1, 1, 1);
 
 		/* draw plus numbers */
 		drawBalls(coupon_pn, TOTAL_BALL_PN, 1, keyb2, 1, 1, 1, 1, 1, 1, 1);
 		printListXYWithPNByKey(coupon, coupon_pn, fp);
+		printf("\nSeed: %lu (draw %u of the run%s)\n", (unsigned long) randomSeed, couponDraws, drawThreads ? ", --threads" : "");
+		fprintf(fp, "\nSeed: %lu (draw %u of the run%s)\n", (unsigned long) randomSeed, couponDraws, drawThreads ? ", --threads" : "");
 		removeAllXY(coupon_pn);
 		removeAllXY(coupon);
+		clearCouponIndex(coupon_pn->couponIndex);
+		clearCouponIndex(coupon->couponIndex);
 
 	} else if (keyb == 2) {
 		printf("Calculation results are writing to %s file...\n", OUTPUTFILE);
@@ -5164,6 +10196,21 @@ keybCommand:
 		#if defined(__MSDOS__)
 		removeAllXY(luckyBalls4);
 		#endif
+	} else if (keyb == 10) {
+		printf("\nInput the numbers separated by commas (e.g. 8,22,55,71) : ");
+
+		do {
+			scanf("%s",input);
+			if ((keyb2 = getQueryBalls(input, queryBalls)) > 0) {
+				break;
+			} else {
+				printf("incorrect input!\n");
+			}
+		} while (1);
+
+		puts("");
+
+		queryDraws(queryBalls, (UINT8) keyb2, 0, fp);
 	}
 
 	printf("\nThe results are written to %s file.\n", OUTPUTFILE);
@@ -5180,7 +10227,8 @@ keybCommand:
 
 exitProgram:
 
-	removeAllXY(winningDrawnBallsList);
+	removeBallPostings(ballPostings);
+	removeAllT(winningDrawnBallsList);
 	removeAllX2(winningBallsDrawCount);
 	removeAllX2(plusNumberBallsDrawCount);
 